@@ -1,6 +1,11 @@
 set SRC_FILES=chess.c main.c types.c 
+set RULES_FILES=chess_rules.c
 set EXT_FILES=lib/glad/src/glad.c lib/stb_image/stb_image.c
-set LIBS=-Llib/SDL/lib -lmingw32 -lSDL2main -lSDL2
+set LIBS=-Llib/SDL/lib -lmingw32 -lSDL2main -lSDL2 -lpthread
 set INCLUDES=-Ilib/SDL/include -Ilib/glad/include -Ilib/stb_image
 set DEFINES=-DSDL_MAIN_HANDLED -D_DEBUG
-gcc %SRC_FILES% %EXT_FILES% %LIBS% %INCLUDES% %DEFINES% -o chess.exe
\ No newline at end of file
+gcc -c %RULES_FILES% -O3
+ar rcs libchess_rules.a chess_rules.o
+gcc %SRC_FILES% %EXT_FILES% libchess_rules.a %LIBS% %INCLUDES% %DEFINES% -o chess.exe
+gcc perft.c libchess_rules.a -O3 -lpthread -o perft.exe
+gcc epd.c libchess_rules.a -O3 -lpthread -o epd.exe
\ No newline at end of file
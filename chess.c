@@ -3,6 +3,7 @@
 #include <stdlib.h>
 #include <glad/glad.h>
 #include <stb_image.h>
+#include <stddef.h>
 #include <string.h>
 
 /* ============================ */
@@ -14,31 +15,53 @@ SDL_GLContext sdl_gl_context;
 bool8 window_open;
 
 typedef struct {
-    bool8 white_turn;
+    chess_game* game;
+    const chess_game_status* status;
     chess_piece selected_chess_piece;
+    /* filled when a piece is selected so the frame loop only reads them */
+    const chess_move* selected_moves;
+    u32 selected_move_count;
+    u64 selected_legal_targets;
+    u64 selected_illegal_targets;
+    bool8 should_reset_game;
 } game_state;
 
-static game_state s_game_state;
-
-typedef struct {
-    chess_piece* pieces;
-    u32 piece_count;
-} chess_board;
-
-static chess_board board_data;
-
-#define BOARD_X_SIZE 8
-#define BOARD_Y_SIZE 8
-
-static bool8 selected_any_chess_piece() { 
-    return s_game_state.selected_chess_piece.board_pos.x != -1.0f && s_game_state.selected_chess_piece.board_pos.y != -1.0f;
-}
-static bool8 piece_is_playing_color(chess_piece piece) {
-    return ((s_game_state.white_turn && piece.is_white) ||
-                    (!s_game_state.white_turn && !piece.is_white));
+static bool8 selected_any_chess_piece(const game_state* state) { 
+    return state->selected_chess_piece.board_pos.x != -1.0f && state->selected_chess_piece.board_pos.y != -1.0f;
+}
+static bool8 piece_is_playing_color(const game_state* state, chess_piece piece) {
+    return ((is_white_turn(state->game) && piece.is_white) ||
+                    (!is_white_turn(state->game) && !piece.is_white));
+}
+static bool8 is_piece_on_board_pos(const game_state* state, vec2 board_pos) {
+    return get_chess_piece_by_board_pos(state->game, board_pos).type != chess_piece_type_none;
+}
+static void deselect_chess_piece(game_state* state) {
+    state->selected_chess_piece.board_pos = (vec2){-1.0f, -1.0f};
+    state->selected_move_count = 0;
+    state->selected_legal_targets = 0;
+    state->selected_illegal_targets = 0;
+}
+static void select_chess_piece(game_state* state, chess_piece piece) {
+    deselect_chess_piece(state);
+    state->selected_chess_piece = piece;
+    u32 square = board_pos_to_square(piece.board_pos);
+    state->selected_moves = get_chess_game_status_moves(state->status, square, &state->selected_move_count);
+    for (u32 i = 0; i < state->selected_move_count; i++) {
+        state->selected_legal_targets |= 1ULL << chess_move_to(state->selected_moves[i]);
+    }
+    chess_move_list pseudo_legal_moves;
+    get_available_moves_from_chess_piece(state->game, piece, &pseudo_legal_moves);
+    for (u32 i = 0; i < pseudo_legal_moves.count; i++) {
+        state->selected_illegal_targets |= 1ULL << chess_move_to(pseudo_legal_moves.moves[i]);
+    }
+    state->selected_illegal_targets &= ~state->selected_legal_targets;
 }
-static bool8 is_piece_on_board_pos(vec2 board_pos) {
-    return get_chess_piece_by_board_pos(board_pos).type != chess_piece_type_none;
+static void render_targets_on_chess_board(vec4 color, u64 targets) {
+    while (targets) {
+        render_quad_on_chess_board(color, square_to_board_pos(__builtin_ctzll(targets)), 0.5f);
+        targets &= targets - 1;
+    }
 }
 
 /* ============================ */
@@ -91,6 +114,90 @@ void sdl_setup_window(const char* window_title) {
 /* APPLICATION STRUCTURE API*/
 /* ============================ */
 
+static render_mode get_requested_render_mode() {
+    const char* requested = getenv("CHESS_RENDER_MODE");
+    if (requested && strcmp(requested, "event") == 0) return render_mode_event_driven;
+    return render_mode_continuous;
+}
+
+static void render_game_state(const game_state* state) {
+    begin_render_frame();
+    glClear(GL_COLOR_BUFFER_BIT);    
+    glClearColor(0.2f, 0.3f, 0.8f, 1.0f);
+    render_chess_board_bg();
+    render_chess_pieces_on_board(state->game);
+
+    if (state->status->in_check) {
+        render_quad_on_chess_board((vec4){0.8f, 0.2f, 0.3f, 1.0f}, get_king_position(state->game, is_white_turn(state->game)), 0.5f);
+    }
+
+    if (selected_any_chess_piece(state)) {
+        render_quad_on_chess_board((vec4){0.2f, 0.3f, 0.8f, 0.4f}, state->selected_chess_piece.board_pos, 1.0f);
+        render_targets_on_chess_board((vec4){0.2f, 0.8f, 0.3f, 1.0f}, state->selected_legal_targets);
+        render_targets_on_chess_board((vec4){0.8f, 0.2f, 0.3f, 1.0f}, state->selected_illegal_targets);
+    }
+    flush_quad_batch();
+}
+
+/* returns true when the event changed what is on screen */
+static bool8 handle_application_event(game_state* state, const SDL_Event* ev) {
+    if (ev->type == SDL_QUIT) {
+        window_open = false;
+        return false;
+    }
+    if (ev->type == SDL_WINDOWEVENT) {
+        return ev->window.event == SDL_WINDOWEVENT_EXPOSED || ev->window.event == SDL_WINDOWEVENT_SHOWN ||
+               ev->window.event == SDL_WINDOWEVENT_RESTORED || ev->window.event == SDL_WINDOWEVENT_SIZE_CHANGED;
+    }
+    if (ev->type != SDL_MOUSEBUTTONDOWN || ev->button.button != SDL_BUTTON_LEFT) return false;
+
+    if(state->should_reset_game) {
+        chess_board_default_placement(state->game);
+        state->status = get_chess_game_status(state->game);
+        deselect_chess_piece(state);
+        state->should_reset_game = false;
+        return true;
+    }
+    i32 x, y;
+    SDL_GetMouseState(&x, &y);  
+    int x_grid = (int)(x / (WINDOW_WIDTH / BOARD_X_SIZE));
+    int y_grid = (int)(y / (WINDOW_HEIGHT / BOARD_Y_SIZE));
+    if (!is_board_pos_on_board((vec2){x_grid, y_grid})) return false;
+    u32 clicked_square = board_pos_to_square((vec2){x_grid, y_grid});
+
+    if (is_piece_on_board_pos(state, (vec2){x_grid, y_grid}) && 
+        piece_is_playing_color(state, get_chess_piece_by_board_pos(state->game, (vec2){x_grid, y_grid}))) {
+        select_chess_piece(state, get_chess_piece_by_board_pos(state->game, (vec2){x_grid, y_grid}));
+        return true;
+    }
+    if (!(state->selected_legal_targets & (1ULL << clicked_square))) {
+        bool8 had_selection = selected_any_chess_piece(state);
+        deselect_chess_piece(state);
+        return had_selection;
+    }
+    bool8 moved = false;
+    for (u32 i = 0; i < state->selected_move_count; i++) {
+        if (chess_move_to(state->selected_moves[i]) == clicked_square) {
+            moved = make_chess_move(state->game, state->selected_moves[i]);
+            break;
+        }
+    }
+    state->status = get_chess_game_status(state->game);
+    deselect_chess_piece(state);
+
+    if (!moved) {
+        printf("Move limit reached, the game is drawn!\n");
+        state->should_reset_game = true;
+    } else if (state->status->is_checkmate) {
+        printf("%s won the game!\n", is_white_turn(state->game) ? "Black" : "White");
+        state->should_reset_game = true;
+    } else if (state->status->is_stalemate) {
+        printf("Stalemate, the game is drawn!\n");
+        state->should_reset_game = true;
+    }
+    return true;
+}
+
 void application_loop() {
     window_open = true;
     SDL_Event ev;
@@ -98,124 +205,51 @@ void application_loop() {
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
     init_quad_renderer();
-    init_chess_board();
-    chess_board_default_placement();
-
-    s_game_state.selected_chess_piece.board_pos = (vec2){-1.0f, -1.0f};
-    s_game_state.white_turn = true; 
-    
-    bool8 should_reset_game = false;
+    game_state state = {.game = chess_game_create()};
+    sdl_assert_msg(state.game != NULL, "Failed to allocate the chess game");
+    printf("Slider attack backend: %s\n", get_slider_attack_backend_name(get_slider_attack_backend()));
+    chess_board_default_placement(state.game);
+    state.status = get_chess_game_status(state.game);
+    deselect_chess_piece(&state);
+
+    render_mode mode = get_requested_render_mode();
+    printf("Render mode: %s\n", mode == render_mode_event_driven ? "event" : "continuous");
+    bool8 needs_redraw = true;
+    u64 frames_rendered = 0;
+    u64 frames_skipped = 0;
+    u64 draw_calls = 0;
+    u64 idle_ticks = 0;
+    u64 start_ticks = SDL_GetPerformanceCounter();
 
     while (window_open) {
-        glClear(GL_COLOR_BUFFER_BIT);    
-        glClearColor(0.2f, 0.3f, 0.8f, 1.0f);
-        render_chess_board_bg();
-        render_chess_pieces_on_board();
-        vec2 available_moves[96];
-        memset(available_moves, -1.0f, sizeof(available_moves));
-        u32 available_moves_count = 0;
-
-        if(is_king_in_check(!s_game_state.white_turn)) {
-                render_quad_on_chess_board((vec4){0.8f, 0.2f, 0.3f, 1.0f}, get_king_position(!s_game_state.white_turn), 0.5f);
-        } 
-        if(is_king_in_check(s_game_state.white_turn)) {
-            render_quad_on_chess_board((vec4){0.8f, 0.2f, 0.3f, 1.0f}, get_king_position(s_game_state.white_turn), 0.5f);
-        }
-
-        if (selected_any_chess_piece()) {
-            render_quad_on_chess_board((vec4){0.2f, 0.3f, 0.8f, 0.4f}, s_game_state.selected_chess_piece.board_pos, 1.0f);
-
-            available_moves_count = get_available_moves_from_chess_piece(s_game_state.selected_chess_piece, available_moves);
-            if (piece_is_playing_color(s_game_state.selected_chess_piece)) {
-                for (u32 i = 0; i < available_moves_count; i++) {
-                    if(is_king_in_check_after_move(s_game_state.selected_chess_piece.board_pos, available_moves[i], !s_game_state.white_turn)) {
-                        render_quad_on_chess_board((vec4){0.8f, 0.2f, 0.3f, 1.0f}, available_moves[i], 0.5f);
-                        available_moves[i] = (vec2){-1.0f, -1.0f};
-                    } else {
-                        render_quad_on_chess_board((vec4){0.2f, 0.8f, 0.3f, 1.0f}, available_moves[i], 0.5f); 
-                    }
-                }
-            }
+        if (needs_redraw || mode == render_mode_continuous) {
+            render_game_state(&state);
+            SDL_GL_SwapWindow(sdl_window);
+            draw_calls += get_render_frame_stats().draw_calls;
+            frames_rendered++;
+            needs_redraw = false;
+        } else {
+            frames_skipped++;
         }
 
-        if(is_king_in_check(!s_game_state.white_turn) || is_king_in_check(s_game_state.white_turn)) {
-            bool8 has_available_moves = false;
-            for(u32 i = 0; i < available_moves_count; i++) {
-                if(available_moves[i].x != -1.0f && available_moves[i].y != -1.0f) {
-                    has_available_moves = true;
-                }
-            }
-            if(!has_available_moves) {
-                if(!should_reset_game)
-                    printf("%s won the game!\n", !s_game_state.white_turn ? "White" : "Black");
-                should_reset_game = true;
-            }
+        /* blocks until input arrives, a wake-up that changes nothing counts as a skipped frame */
+        if (mode == render_mode_event_driven) {
+            u64 wait_start = SDL_GetPerformanceCounter();
+            bool8 got_event = SDL_WaitEvent(&ev);
+            idle_ticks += SDL_GetPerformanceCounter() - wait_start;
+            if (got_event) needs_redraw |= handle_application_event(&state, &ev);
         }
-
-        SDL_GL_SwapWindow(sdl_window);
-
         while (SDL_PollEvent(&ev)) {
-            if (ev.type == SDL_QUIT) {
-                window_open = false;
-            }
-            if (ev.type == SDL_MOUSEBUTTONDOWN) {
-                if (ev.button.button == SDL_BUTTON_LEFT) {
-                    if(should_reset_game) {
-                        chess_board_default_placement();
-                        s_game_state.selected_chess_piece.board_pos = (vec2){-1.0f, -1.0f};
-                        s_game_state.white_turn = true;
-                        should_reset_game = false;
-                    } else {
-                        i32 x, y;
-                        SDL_GetMouseState(&x, &y);  
-                        int x_grid = (int)(x / (WINDOW_WIDTH / BOARD_X_SIZE));
-                        int y_grid = (int)(y / (WINDOW_HEIGHT / BOARD_Y_SIZE));
-                    
-                        if (is_piece_on_board_pos((vec2){x_grid, y_grid}) && 
-                            piece_is_playing_color(get_chess_piece_by_board_pos((vec2){x_grid, y_grid}))) {
-                            s_game_state.selected_chess_piece = get_chess_piece_by_board_pos((vec2){x_grid, y_grid});
-                        } else {
-                            bool8 can_delesect = true;
-                            for (u32 i = 0; i < available_moves_count; i++) {
-                                if (available_moves[i].x == x_grid && available_moves[i].y == y_grid) {
-                                    can_delesect = false;
-                                    break;
-                                }
-                            }
-                            if (can_delesect)
-                                s_game_state.selected_chess_piece.board_pos = (vec2){-1.0f, -1.0f};
-                        }
-                        for (u32 i = 0; i < available_moves_count; i++) {
-                            if(available_moves[i].x == -1.0f || available_moves[i].y == -1.0f) continue;
-                            if (available_moves[i].x == x_grid && available_moves[i].y == y_grid) {
-                                if (piece_is_playing_color(s_game_state.selected_chess_piece)) {
-                                    s_game_state.white_turn = !s_game_state.white_turn;
-                                    vec2 selected_move = available_moves[i];
-                                    if (is_piece_on_board_pos(selected_move)) {
-                                        remove_chess_piece_from_board(selected_move);
-                                    }      
-                                    move_chess_piece_on_board(s_game_state.selected_chess_piece.board_pos, selected_move);
-                                    s_game_state.selected_chess_piece.board_pos = selected_move;
-                                    if (s_game_state.selected_chess_piece.type == chess_piece_type_pawn) {
-                                    for (u32 i = 0; i < board_data.piece_count; i++) {
-                                        if (board_data.pieces[i].board_pos.x == s_game_state.selected_chess_piece.board_pos.x &&
-                                            board_data.pieces[i].board_pos.y == s_game_state.selected_chess_piece.board_pos.y) {
-                                            board_data.pieces[i].pawn_moved = true;
-                                            }
-                                        }
-                                    }                                
-                                }
-                                s_game_state.selected_chess_piece.board_pos = (vec2){-1.0f, -1.0f};
-                                break;
-                            }
-                        }
-                    }
-                }
-            }
+            needs_redraw |= handle_application_event(&state, &ev);
         }
     }
+    double frequency = (double)SDL_GetPerformanceFrequency();
+    printf("Frames rendered: %llu, skipped: %llu\n", frames_rendered, frames_skipped);
+    printf("Idle: %.1fs of %.1fs\n", idle_ticks / frequency, (SDL_GetPerformanceCounter() - start_ticks) / frequency);
+    printf("Draw calls per frame: %.1f (last frame: %u)\n", frames_rendered ? (double)draw_calls / frames_rendered : 0.0,
+           get_render_frame_stats().draw_calls);
 
-    destroy_chess_board();
+    chess_game_destroy(state.game);
     terminate_quad_renderer();
 }
 void application_terminate() {
@@ -268,6 +302,23 @@ static u32 compile_opengl_shader(const char* path, GLenum type) {
     return shader;
 }
 
+static void cache_opengl_shader_uniforms(opengl_shader* program) {
+    i32 uniform_count;
+    glGetProgramiv(program->id, GL_ACTIVE_UNIFORMS, &uniform_count);
+    program->uniforms = calloc(uniform_count, sizeof(opengl_shader_uniform));
+    if (!program->uniforms) return;
+
+    for (i32 i = 0; i < uniform_count; i++) {
+        opengl_shader_uniform* uniform = &program->uniforms[program->uniform_count];
+        i32 size;
+        GLenum type;
+        glGetActiveUniform(program->id, i, OPENGL_UNIFORM_NAME_LENGTH, NULL, &size, &type, uniform->name);
+        uniform->location = glGetUniformLocation(program->id, uniform->name);
+        /* members of uniform blocks have no location */
+        if (uniform->location != -1) program->uniform_count++;
+    }
+}
+
 static void link_opengl_shader_program(opengl_shader* program, u32 vertex_shader, u32 fragment_shader) {
     int link_success;
     char info_log[512];
@@ -287,6 +338,7 @@ static void link_opengl_shader_program(opengl_shader* program, u32 vertex_shader
         printf("%s\n", info_log);
     } else {
         printf("Successfully linked shader program (ID: %i)\n", program->id);
+        cache_opengl_shader_uniforms(program);
     }
 
     glDeleteShader(vertex_shader);
@@ -294,7 +346,7 @@ static void link_opengl_shader_program(opengl_shader* program, u32 vertex_shader
 }
 
 opengl_shader opengl_shader_create(const char* vertex_path, const char* fragment_path) {
-    opengl_shader program;
+    opengl_shader program = {0};
 
     u32 vertex_shader = compile_opengl_shader(vertex_path, GL_VERTEX_SHADER);
     u32 fragment_shader = compile_opengl_shader(fragment_path, GL_FRAGMENT_SHADER);
@@ -313,31 +365,63 @@ void opengl_shader_unbind() {
 }
 
 void opengl_shader_delete(opengl_shader shader) {
-    glDeleteShader(shader.id);
+    glDeleteProgram(shader.id);
+    free(shader.uniforms);
+}
+
+opengl_uniform opengl_shader_get_uniform(opengl_shader shader, const char* name) {
+    for (u32 i = 0; i < shader.uniform_count; i++) {
+        if (strcmp(shader.uniforms[i].name, name) == 0) return shader.uniforms[i].location;
+    }
+    return -1;
+}
+
+void opengl_uniform_upload_int(opengl_uniform uniform, int i) {
+    glUniform1i(uniform, i);
+}
+
+void opengl_uniform_upload_float(opengl_uniform uniform, float f) {
+    glUniform1f(uniform, f);
+}
+
+void opengl_uniform_upload_vec2(opengl_uniform uniform, vec2 v) {
+    glUniform2f(uniform, v.x, v.y);
+}
+
+void opengl_uniform_upload_vec3(opengl_uniform uniform, vec3 v) {
+    glUniform3f(uniform, v.x, v.y, v.z);
+}
+
+void opengl_uniform_upload_vec4(opengl_uniform uniform, vec4 v) {
+    glUniform4f(uniform, v.x, v.y, v.z, v.w);
+}
+
+void opengl_uniform_upload_mat4(opengl_uniform uniform, mat4 m) {
+    glUniformMatrix4fv(uniform, 1, false, (float*)&m);
 }
 
 void opengl_shader_upload_int(opengl_shader shader, int i, const char* name) {
-    glUniform1i(glGetUniformLocation(shader.id, name), i);
+    opengl_uniform_upload_int(opengl_shader_get_uniform(shader, name), i);
 }
 
 void opengl_shader_upload_float(opengl_shader shader, float f, const char* name) {
-    glUniform1f(glGetUniformLocation(shader.id, name), f);
+    opengl_uniform_upload_float(opengl_shader_get_uniform(shader, name), f);
 }
 
 void opengl_shader_upload_vec2(opengl_shader shader, vec2 v, const char* name) {
-    glUniform2f(glGetUniformLocation(shader.id, name), v.x, v.y);
+    opengl_uniform_upload_vec2(opengl_shader_get_uniform(shader, name), v);
 }
 
 void opengl_shader_upload_vec3(opengl_shader shader, vec3 v, const char* name) {
-    glUniform3f(glGetUniformLocation(shader.id, name), v.x, v.y, v.z);
+    opengl_uniform_upload_vec3(opengl_shader_get_uniform(shader, name), v);
 }
 
 void opengl_shader_upload_vec4(opengl_shader shader, vec4 v, const char* name) {
-    glUniform4f(glGetUniformLocation(shader.id, name), v.x, v.y, v.z, v.w);
+    opengl_uniform_upload_vec4(opengl_shader_get_uniform(shader, name), v);
 }
 
 void opengl_shader_upload_mat4(opengl_shader shader, mat4 m, const char* name) {
-    glUniformMatrix4fv(glGetUniformLocation(shader.id, name), 1, false, (float*)&m);
+    opengl_uniform_upload_mat4(opengl_shader_get_uniform(shader, name), m);
 }
 
 /* ============================ */
@@ -413,510 +497,288 @@ subtexture_coords subtexture_get_texcoords(subtexture texture) {
     return coords;
 }
 
+/* ============================ */
+/*   OPENGL STREAM BUFFER API   */
+/* ============================ */
+
+opengl_stream_buffer opengl_stream_buffer_create(u32 region_size) {
+    opengl_stream_buffer ret = {0};
+    ret.region_size = region_size;
+
+    GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glCreateBuffers(1, &ret.id);
+    glNamedBufferStorage(ret.id, region_size * STREAM_BUFFER_REGIONS, NULL, flags);
+    ret.mapped = glMapNamedBufferRange(ret.id, 0, region_size * STREAM_BUFFER_REGIONS, flags);
+    if (!ret.mapped) {
+        printf("Failed to map stream buffer (ID: %i)\n", ret.id);
+    }
+    return ret;
+}
+
+void opengl_stream_buffer_delete(opengl_stream_buffer* buffer) {
+    for (u32 i = 0; i < STREAM_BUFFER_REGIONS; i++) {
+        if (buffer->fences[i]) glDeleteSync(buffer->fences[i]);
+        buffer->fences[i] = NULL;
+    }
+    glUnmapNamedBuffer(buffer->id);
+    glDeleteBuffers(1, &buffer->id);
+    buffer->mapped = NULL;
+}
+
+void* opengl_stream_buffer_alloc(opengl_stream_buffer* buffer, u32 size, u32* offset) {
+    if (!buffer->mapped || buffer->offset + size > buffer->region_size) return NULL;
+    *offset = buffer->region * buffer->region_size + buffer->offset;
+    buffer->offset += size;
+    return buffer->mapped + *offset;
+}
+
+void opengl_stream_buffer_next_region(opengl_stream_buffer* buffer) {
+    buffer->fences[buffer->region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    buffer->region = (buffer->region + 1) % STREAM_BUFFER_REGIONS;
+    buffer->offset = 0;
+
+    GLsync fence = buffer->fences[buffer->region];
+    if (!fence) return;
+    GLenum result;
+    do {
+        result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+    } while (result == GL_TIMEOUT_EXPIRED);
+    glDeleteSync(fence);
+    buffer->fences[buffer->region] = NULL;
+}
+
 /* ============================ */
 /*         RENDERER API         */
 /* ============================ */
 
+#define QUAD_FLAG_TEXTURED 0x1
+#define QUAD_FLAG_WHITE_PIECE 0x2
+#define QUAD_FLAG_CHECKERBOARD 0x4
+
+typedef struct {
+    vec2 pos, scale;
+    vec4 color;
+    u32 flags;
+    u32 sprite;
+} quad_instance;
+
+#define FRAME_CONSTANTS_BINDING 0
+#define SPRITE_TABLE_BINDING 1
+#define SPRITE_TABLE_SIZE 8
+
+/* spritesheet cell of every piece type */
+static const vec2 piece_sprite_cells[SPRITE_TABLE_SIZE] = {
+    [chess_piece_type_pawn] = {0.0f, 0.0f},
+    [chess_piece_type_bishop] = {4.0f, 0.0f},
+    [chess_piece_type_knight] = {5.0f, 0.0f},
+    [chess_piece_type_rook] = {1.0f, 0.0f},
+    [chess_piece_type_queen] = {2.0f, 0.0f},
+    [chess_piece_type_king] = {3.0f, 0.0f}};
+
+/* std140 layout of the sprite_table uniform block, uv min in xy and max in zw */
+typedef struct {
+    vec4 uvs[SPRITE_TABLE_SIZE];
+} sprite_table;
+
+/* std140 layout of the frame_constants uniform block */
+typedef struct {
+    mat4 proj;
+    vec4 board_light_color;
+    vec4 board_dark_color;
+    float board_square_size;
+    float padding[3];
+} frame_constants;
+
 typedef struct {
-    u32 vao, vbo, ibo;
+    u32 vao, vbo, ibo, ubo, sprite_ubo;
+    opengl_stream_buffer instance_buffer;
     opengl_shader shader;
+    opengl_uniform u_texture;
+    frame_constants constants;
+    bool8 constants_dirty;
     opengl_texture spritesheet;
+    u32 first_instance;
+    u32 instance_count;
+    render_frame_stats stats;
 } render_data;
 
 static render_data r_data;
 
+static void enable_quad_instance_attrib(u32 index, u32 count, u32 offset) {
+    glEnableVertexAttribArray(index);
+    glVertexAttribPointer(index, count, GL_FLOAT, GL_FALSE, sizeof(quad_instance), (void*)(intptr_t)offset);
+    glVertexAttribDivisor(index, 1);
+}
+
 void init_quad_renderer() {
     glCreateVertexArrays(1, &r_data.vao);
     glBindVertexArray(r_data.vao);
 
     r_data.spritesheet = opengl_texture_create("spritesheet.png");
 
+    float vertices[] = {
+        -0.5f, -0.5f, 0.0f, 0.0f,
+        -0.5f, 0.5f, 0.0f, 1.0f,
+        0.5f, 0.5f, 1.0f, 1.0f,
+        0.5f, -0.5f, 1.0f, 0.0f};
     u32 indices[] = {0, 1, 2, 2, 3, 0};
 
     glCreateBuffers(1, &r_data.vbo);
     glBindBuffer(GL_ARRAY_BUFFER, r_data.vbo);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 5 * 6, NULL, GL_DYNAMIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
 
     glCreateBuffers(1, &r_data.ibo);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, r_data.ibo);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
 
     glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(float) * 5, NULL);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(float) * 4, NULL);
 
     glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(float) * 5, (void*)(intptr_t)(sizeof(float) * 3));
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(float) * 4, (void*)(intptr_t)(sizeof(float) * 2));
+
+    r_data.instance_buffer = opengl_stream_buffer_create(sizeof(quad_instance) * MAX_QUAD_INSTANCES);
+    glBindBuffer(GL_ARRAY_BUFFER, r_data.instance_buffer.id);
+
+    /* pos and scale are read as one vec4 */
+    enable_quad_instance_attrib(2, 4, offsetof(quad_instance, pos));
+    enable_quad_instance_attrib(3, 4, offsetof(quad_instance, color));
+    glEnableVertexAttribArray(4);
+    glVertexAttribIPointer(4, 2, GL_UNSIGNED_INT, sizeof(quad_instance), (void*)(intptr_t)offsetof(quad_instance, flags));
+    glVertexAttribDivisor(4, 1);
+
+    sprite_table sprites = {0};
+    for (u32 i = 0; i < SPRITE_TABLE_SIZE; i++) {
+        if (i == chess_piece_type_none || i > chess_piece_type_king) continue;
+        subtexture subtex = subtexture_create(r_data.spritesheet,
+                                              piece_sprite_cells[i], (vec2){64.0f, 64.0f}, (vec2){1.0f, 1.0f});
+        subtexture_coords coords = subtexture_get_texcoords(subtex);
+        sprites.uvs[i] = (vec4){coords.min.x, coords.min.y, coords.max.x, coords.max.y};
+    }
+    glCreateBuffers(1, &r_data.sprite_ubo);
+    glNamedBufferStorage(r_data.sprite_ubo, sizeof(sprites), &sprites, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, SPRITE_TABLE_BINDING, r_data.sprite_ubo);
+
+    glCreateBuffers(1, &r_data.ubo);
+    glNamedBufferStorage(r_data.ubo, sizeof(frame_constants), NULL, GL_DYNAMIC_STORAGE_BIT);
+    glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_CONSTANTS_BINDING, r_data.ubo);
+    r_data.constants.proj = mat4_orthographic(0.0f, WINDOW_WIDTH, WINDOW_HEIGHT, 0.0f);
+    r_data.constants_dirty = true;
 
     r_data.shader = opengl_shader_create("vert.glsl", "frag.glsl");
+    r_data.u_texture = opengl_shader_get_uniform(r_data.shader, "u_texture");
     opengl_shader_bind(r_data.shader);
+    opengl_uniform_upload_int(r_data.u_texture, 0);
 }
 
 void terminate_quad_renderer() {
+    opengl_stream_buffer_delete(&r_data.instance_buffer);
+    glDeleteBuffers(1, &r_data.sprite_ubo);
+    glDeleteBuffers(1, &r_data.ubo);
+    glDeleteBuffers(1, &r_data.ibo);
+    glDeleteBuffers(1, &r_data.vbo);
+    glDeleteVertexArrays(1, &r_data.vao);
     opengl_shader_delete(r_data.shader);
     opengl_texture_delete(r_data.spritesheet);
 }
-void render_quad(vec2 uv, vec4 color, vec2 pos, vec2 scale) {
-    opengl_texture_bind(r_data.spritesheet);
-    opengl_shader_bind(r_data.shader);
-    opengl_shader_upload_int(r_data.shader, 0, "u_texture");
-    opengl_shader_upload_mat4(r_data.shader, mat4_orthographic(0.0f, WINDOW_WIDTH, WINDOW_HEIGHT, 0.0f), "u_proj");
-    opengl_shader_upload_mat4(r_data.shader, mat4_mul(mat4_translate(mat4_identity(), (vec3){pos.x, pos.y, 0.0f}), mat4_scale(mat4_identity(), (vec3){scale.x, scale.y, 0.0f})), "u_model");
-    opengl_shader_upload_int(r_data.shader, true, "u_using_textures");
-    opengl_shader_upload_vec4(r_data.shader, color, "u_color");
-    subtexture subtex = subtexture_create(r_data.spritesheet,
-                                          uv, (vec2){64.0f, 64.0f}, (vec2){1.0f, 1.0f});
-
-    subtexture_coords coords = subtexture_get_texcoords(subtex);
-    float vertices[] = {
-        -0.5f, -0.5f, 0.0f, coords.min.x, coords.min.y,
-        -0.5f, 0.5f, 0.0f, coords.min.x, coords.max.y,
-        0.5f, 0.5f, 0.0f, coords.max.x, coords.max.y,
-        0.5f, -0.5f, 0.0f, coords.max.x, coords.min.y};
-    glBindVertexArray(r_data.vao);
-    glBindBuffer(GL_ARRAY_BUFFER, r_data.vbo);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
 
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, NULL);
+void begin_render_frame() {
+    opengl_stream_buffer_next_region(&r_data.instance_buffer);
+    r_data.stats.draw_calls = 0;
+    r_data.stats.quads = 0;
 }
 
-void render_quad_color(vec4 color, vec2 pos, vec2 scale) {
-    opengl_shader_bind(r_data.shader);
-    opengl_shader_upload_int(r_data.shader, 0, "u_texture");
-    opengl_shader_upload_mat4(r_data.shader, mat4_orthographic(0.0f, WINDOW_WIDTH, WINDOW_HEIGHT, 0.0f), "u_proj");
-    opengl_shader_upload_mat4(r_data.shader, mat4_mul(mat4_translate(mat4_identity(), (vec3){pos.x, pos.y, 0.0f}), mat4_scale(mat4_identity(), (vec3){scale.x, scale.y, 0.0f})), "u_model");
-    opengl_shader_upload_int(r_data.shader, false, "u_using_textures");
-    opengl_shader_upload_vec4(r_data.shader, color, "u_color");
-    float vertices[] = {
-        -0.5f, -0.5f, 0.0f, 0.0f, 0.0f,
-        -0.5f, 0.5f, 0.0f, 0.0f, 1.0f,
-        0.5f, 0.5f, 0.0f, 1.0f, 1.0f,
-        0.5f, -0.5f, 0.0f, 1.0f, 0.0f};
-    glBindVertexArray(r_data.vao);
-    glBindBuffer(GL_ARRAY_BUFFER, r_data.vbo);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, NULL);
+render_frame_stats get_render_frame_stats() {
+    return r_data.stats;
 }
 
-/* ============================ */
-/*        CHESS GAME API        */
-/* ============================ */
-
-void render_chess_board_bg() {
-    for (u32 y = 0; y < BOARD_Y_SIZE; y++) {
-        for (u32 x = 0; x < BOARD_X_SIZE; x++) {
-            bool8 cond = (y % 2 != 0) ? x % 2 == 0 : x % 2 != 0;
-            if (cond) {
-                render_quad_color((vec4){242 / 255.0f, 225 / 255.0f, 172 / 255.0f, 1.0f},
-                                  (vec2){50 + WINDOW_HEIGHT / BOARD_X_SIZE * x, 50.0f + WINDOW_WIDTH / BOARD_Y_SIZE * y}, (vec2){WINDOW_HEIGHT / BOARD_X_SIZE, WINDOW_WIDTH / BOARD_Y_SIZE});
-            } else {
-                render_quad_color((vec4){13 / 255.0f, 115 / 255.0f, 40 / 255.0f, 1.0f},
-                                  (vec2){50 + WINDOW_HEIGHT / BOARD_X_SIZE * x, 50.0f + WINDOW_WIDTH / BOARD_Y_SIZE * y}, (vec2){WINDOW_HEIGHT / BOARD_X_SIZE, WINDOW_WIDTH / BOARD_Y_SIZE});
-            }
-        }
+void flush_quad_batch() {
+    if (r_data.instance_count == 0) return;
+    if (r_data.constants_dirty) {
+        glNamedBufferSubData(r_data.ubo, 0, sizeof(frame_constants), &r_data.constants);
+        r_data.constants_dirty = false;
     }
-}
-
-void init_chess_board() {
-    board_data.pieces = malloc(sizeof(chess_piece) * 64);
-    board_data.piece_count = 0;
-}
-
-void chess_board_default_placement() {
-    free(board_data.pieces); 
-    board_data.pieces = malloc(sizeof(chess_piece) * 64);
-    board_data.piece_count = 0;
+    opengl_shader_bind(r_data.shader);
+    opengl_texture_bind(r_data.spritesheet);
+    glBindVertexArray(r_data.vao);
 
-    add_chess_piece_to_board((vec2){0.0f, 0.0f}, chess_piece_type_rook, false);
-    add_chess_piece_to_board((vec2){1.0f, 0.0f}, chess_piece_type_knight, false);
-    add_chess_piece_to_board((vec2){2.0f, 0.0f}, chess_piece_type_bishop, false);
-    add_chess_piece_to_board((vec2){3.0f, 0.0f}, chess_piece_type_queen, false);
-    add_chess_piece_to_board((vec2){4.0f, 0.0f}, chess_piece_type_king, false);
-    add_chess_piece_to_board((vec2){5.0f, 0.0f}, chess_piece_type_bishop, false);
-    add_chess_piece_to_board((vec2){6.0f, 0.0f}, chess_piece_type_knight, false);
-    add_chess_piece_to_board((vec2){7.0f, 0.0f}, chess_piece_type_rook, false);
-    for (u32 x = 0; x < 8; x++) {
-        add_chess_piece_to_board((vec2){x, 1.0f}, chess_piece_type_pawn, false);
+    glDrawElementsInstancedBaseInstance(GL_TRIANGLES, 6, GL_UNSIGNED_INT, NULL, r_data.instance_count, r_data.first_instance);
+    r_data.stats.draw_calls++;
+    r_data.stats.quads += r_data.instance_count;
+    r_data.instance_count = 0;
+}
+
+/* instances are written straight into the mapped region of the current frame */
+static void push_quad_instance(quad_instance instance) {
+    u32 offset;
+    quad_instance* dst = opengl_stream_buffer_alloc(&r_data.instance_buffer, sizeof(quad_instance), &offset);
+    if (!dst) {
+        flush_quad_batch();
+        opengl_stream_buffer_next_region(&r_data.instance_buffer);
+        dst = opengl_stream_buffer_alloc(&r_data.instance_buffer, sizeof(quad_instance), &offset);
+        if (!dst) return;
     }
-    add_chess_piece_to_board((vec2){0.0f, 7.0f}, chess_piece_type_rook, true);
-    add_chess_piece_to_board((vec2){1.0f, 7.0f}, chess_piece_type_knight, true);
-    add_chess_piece_to_board((vec2){2.0f, 7.0f}, chess_piece_type_bishop, true);
-    add_chess_piece_to_board((vec2){3.0f, 7.0f}, chess_piece_type_queen, true);
-    add_chess_piece_to_board((vec2){4.0f, 7.0f}, chess_piece_type_king, true);
-    add_chess_piece_to_board((vec2){5.0f, 7.0f}, chess_piece_type_bishop, true);
-    add_chess_piece_to_board((vec2){6.0f, 7.0f}, chess_piece_type_knight, true);
-    add_chess_piece_to_board((vec2){7.0f, 7.0f}, chess_piece_type_rook, true);
-    for (u32 x = 0; x < 8; x++) {
-        add_chess_piece_to_board((vec2){x, 6.0f}, chess_piece_type_pawn, true);
-    }
-}
-void destroy_chess_board() {
-    free(board_data.pieces);
-}
-void add_chess_piece_to_board(vec2 pos, chess_piece_type type, bool8 is_white) {
-    if (pos.x >= BOARD_X_SIZE || pos.y >= BOARD_Y_SIZE) return;
-    board_data.pieces[board_data.piece_count].type = type;
-    board_data.pieces[board_data.piece_count].board_pos = pos;
-    board_data.pieces[board_data.piece_count].is_white = is_white;
-    if (board_data.pieces[board_data.piece_count].type == chess_piece_type_pawn) {
-        board_data.pieces[board_data.piece_count].pawn_moved = false;
-    }
-    board_data.piece_count++;
+    if (r_data.instance_count == 0) r_data.first_instance = offset / sizeof(quad_instance);
+    *dst = instance;
+    r_data.instance_count++;
 }
 
-void move_chess_piece_on_board(vec2 src_pos, vec2 dst_pos) {
-    if (src_pos.x >= BOARD_X_SIZE || src_pos.y >= BOARD_Y_SIZE) return;
-    if (dst_pos.x >= BOARD_X_SIZE || dst_pos.y >= BOARD_Y_SIZE) return;
-    for (u32 i = 0; i < board_data.piece_count; i++) {
-        if (board_data.pieces[i].board_pos.x == src_pos.x &&
-            board_data.pieces[i].board_pos.y == src_pos.y) {
-            board_data.pieces[i].board_pos = dst_pos;
-        }
-    }
+void render_quad(chess_piece_type sprite, vec4 color, vec2 pos, vec2 scale, bool8 white_piece) {
+    push_quad_instance((quad_instance){
+        .pos = pos,
+        .scale = scale,
+        .color = color,
+        .flags = QUAD_FLAG_TEXTURED | (white_piece ? QUAD_FLAG_WHITE_PIECE : 0),
+        .sprite = sprite});
 }
 
-chess_piece get_chess_piece_by_board_pos(vec2 board_pos) {
-    chess_piece ret = {
-        .board_pos = (vec2){-1.0f, -1.0f},
-        .is_white = false,
-        .type = chess_piece_type_none};
-    if (board_pos.x >= BOARD_X_SIZE || board_pos.y >= BOARD_Y_SIZE) return ret;
-    for (u32 i = 0; i < board_data.piece_count; i++) {
-        if(board_data.pieces[i].type == chess_piece_type_none) continue;
-        if (board_data.pieces[i].board_pos.x == board_pos.x && board_data.pieces[i].board_pos.y == board_pos.y) {
-            return board_data.pieces[i];
-        }
-    }
-    return ret;
-}
-void render_chess_pieces_on_board() {
-    for (u32 i = 0; i < board_data.piece_count; i++) {
-        if (board_data.pieces[i].type == chess_piece_type_none) continue;
-        vec2 uv = (vec2){-1.0f, -1.0f};
-        switch (board_data.pieces[i].type) {
-            case chess_piece_type_pawn:
-                uv = (vec2){0.0f, 0.0f};
-                break;
-            case chess_piece_type_bishop:
-                uv = (vec2){4.0f, 0.0f};
-                break;
-            case chess_piece_type_knight:
-                uv = (vec2){5.0f, 0.0f};
-                break;
-            case chess_piece_type_rook:
-                uv = (vec2){1.0f, 0.0f};
-                break;
-            case chess_piece_type_queen:
-                uv = (vec2){2.0f, 0.0f};
-                break;
-            case chess_piece_type_king:
-                uv = (vec2){3.0f, 0.0f};
-                break;
-            default:
-                break;
-        }
-        opengl_shader_bind(r_data.shader);
-        opengl_shader_upload_int(r_data.shader, board_data.pieces[i].is_white, "u_chess_piece_white");
-        render_quad(uv, (vec4){1.0f, 1.0f, 1.0f, 1.0f}, (vec2){((WINDOW_WIDTH / BOARD_Y_SIZE) / 2) + WINDOW_HEIGHT / BOARD_X_SIZE * board_data.pieces[i].board_pos.x, ((WINDOW_WIDTH / BOARD_Y_SIZE) / 2) + WINDOW_WIDTH / BOARD_Y_SIZE * board_data.pieces[i].board_pos.y}, (vec2){WINDOW_HEIGHT / BOARD_X_SIZE, WINDOW_WIDTH / BOARD_Y_SIZE});
+void render_quad_color(vec4 color, vec2 pos, vec2 scale) {
+    push_quad_instance((quad_instance){
+        .pos = pos,
+        .scale = scale,
+        .color = color,
+        .flags = 0,
+        .sprite = 0});
+}
+
+void render_checkerboard(vec4 light_color, vec4 dark_color, vec2 pos, vec2 scale, float square_size) {
+    frame_constants constants = r_data.constants;
+    constants.board_light_color = light_color;
+    constants.board_dark_color = dark_color;
+    constants.board_square_size = square_size;
+    if (memcmp(&constants, &r_data.constants, sizeof(constants)) != 0) {
+        /* quads queued before the change are drawn with the old constants */
+        flush_quad_batch();
+        r_data.constants = constants;
+        r_data.constants_dirty = true;
     }
+    push_quad_instance((quad_instance){
+        .pos = pos,
+        .scale = scale,
+        .color = (vec4){1.0f, 1.0f, 1.0f, 1.0f},
+        .flags = QUAD_FLAG_CHECKERBOARD,
+        .sprite = 0});
 }
 
-void render_quad_on_chess_board(vec4 color, vec2 board_pos, float scaling) {
-    render_quad_color(color, (vec2){((WINDOW_WIDTH / BOARD_X_SIZE) / 2) + WINDOW_WIDTH / BOARD_X_SIZE * board_pos.x, ((WINDOW_HEIGHT / BOARD_Y_SIZE) / 2) + WINDOW_HEIGHT / BOARD_Y_SIZE * board_pos.y}, (vec2){(WINDOW_WIDTH / BOARD_X_SIZE) * scaling, (WINDOW_HEIGHT / BOARD_Y_SIZE) * scaling});
-}
-
-static bool8 is_chess_piece_move_possible(vec2 dst_pos) {
-    return get_chess_piece_by_board_pos(dst_pos).type == chess_piece_type_none;
-}
-
-static u32 get_straight_full_board_moves(chess_piece piece, vec2* available_moves) {
-    u32 moves_count = 0;
-    for(u32 y = 1; y < BOARD_Y_SIZE; y++) {
-        vec2 current_move = (vec2){piece.board_pos.x, piece.board_pos.y - y};
-        if(current_move.x < 0 || current_move.x > BOARD_X_SIZE - 1  || current_move.y < 0 || current_move.y > BOARD_Y_SIZE - 1)
-            continue;
-        chess_piece current_piece = get_chess_piece_by_board_pos(current_move);
-        if(!is_chess_piece_move_possible(current_move) && current_piece.is_white == piece.is_white) 
-            break; 
-        available_moves[moves_count++] = current_move;
-        if(!is_chess_piece_move_possible(current_move) && current_piece.is_white != piece.is_white) 
-            break; 
-    }
-    for(u32 y = 1; y < BOARD_Y_SIZE; y++) {
-        vec2 current_move = (vec2){piece.board_pos.x, piece.board_pos.y + y};
-        if(current_move.x < 0 || current_move.x > BOARD_X_SIZE - 1  || current_move.y < 0 || current_move.y > BOARD_Y_SIZE - 1)
-            continue;
-        chess_piece current_piece = get_chess_piece_by_board_pos(current_move);
-        if(!is_chess_piece_move_possible(current_move) && current_piece.is_white == piece.is_white) 
-            break; 
-        available_moves[moves_count++] = current_move;
-        if(!is_chess_piece_move_possible(current_move) && current_piece.is_white != piece.is_white) 
-            break; 
-    }
-    for(u32 x = 1; x < BOARD_X_SIZE; x++) {
-        vec2 current_move = (vec2){piece.board_pos.x - x, piece.board_pos.y};
-        if(current_move.x < 0 || current_move.x > BOARD_X_SIZE - 1  || current_move.y < 0 || current_move.y > BOARD_Y_SIZE - 1)
-            continue;
-        chess_piece current_piece = get_chess_piece_by_board_pos(current_move);
-        if(!is_chess_piece_move_possible(current_move) && current_piece.is_white == piece.is_white) 
-            break; 
-        available_moves[moves_count++] = current_move;
-        if(!is_chess_piece_move_possible(current_move) && current_piece.is_white != piece.is_white) 
-            break; 
-
-    }
-    for(u32 x = 1; x < BOARD_X_SIZE; x++) {
-        vec2 current_move = (vec2){piece.board_pos.x + x, piece.board_pos.y};
-        if(current_move.x < 0 || current_move.x > BOARD_X_SIZE - 1  || current_move.y < 0 || current_move.y > BOARD_Y_SIZE - 1)
-            continue;
-        chess_piece current_piece = get_chess_piece_by_board_pos(current_move);
-        if(!is_chess_piece_move_possible(current_move) && current_piece.is_white == piece.is_white) 
-            break; 
-        available_moves[moves_count++] = current_move;
-        if(!is_chess_piece_move_possible(current_move) && current_piece.is_white != piece.is_white) 
-            break; 
-    }
-    return moves_count;
-}
-static u32 get_diagonal_full_board_moves(chess_piece piece, vec2* available_moves) {
-    u32 moves_count = 0;
-    for(u32 add = 1; add < BOARD_X_SIZE; add++) { 
-            vec2 current_move = (vec2){piece.board_pos.x - add, piece.board_pos.y - add};
-            if(current_move.x < 0 || current_move.x > BOARD_X_SIZE - 1  || current_move.y < 0 || current_move.y > BOARD_Y_SIZE - 1)
-                continue;
-            chess_piece current_piece = get_chess_piece_by_board_pos(current_move);
-            if(!is_chess_piece_move_possible(current_move) && current_piece.is_white == piece.is_white) 
-                break;
-            available_moves[moves_count++] = current_move;
-            if(!is_chess_piece_move_possible(current_move) && current_piece.is_white != piece.is_white)
-                break;
-        }
-        for(u32 add = 1; add < BOARD_X_SIZE; add++) {
-            vec2 current_move = (vec2){piece.board_pos.x + add, piece.board_pos.y - add};
-            if(current_move.x < 0 || current_move.x > BOARD_X_SIZE - 1  || current_move.y < 0 || current_move.y > BOARD_Y_SIZE - 1)
-                continue;
-            chess_piece current_piece = get_chess_piece_by_board_pos(current_move);
-            if(!is_chess_piece_move_possible(current_move) && current_piece.is_white == piece.is_white) 
-                break;
-            available_moves[moves_count++] = current_move;
-            if(!is_chess_piece_move_possible(current_move) && current_piece.is_white != piece.is_white) 
-                break;
-        }
-        for(u32 add = 1; add < BOARD_X_SIZE; add++) {
-            vec2 current_move = (vec2){piece.board_pos.x - add, piece.board_pos.y + add};
-            if(current_move.x < 0 || current_move.x > BOARD_X_SIZE - 1  || current_move.y < 0 || current_move.y > BOARD_Y_SIZE - 1)
-                continue;
-            chess_piece current_piece = get_chess_piece_by_board_pos(current_move);
-            if(!is_chess_piece_move_possible(current_move) && current_piece.is_white == piece.is_white) 
-                break;
-            available_moves[moves_count++] = current_move;
-            if(!is_chess_piece_move_possible(current_move) && current_piece.is_white != piece.is_white) 
-                break;
-        }
-        for(u32 add = 1; add < BOARD_X_SIZE; add++) {
-            vec2 current_move = (vec2){piece.board_pos.x + add, piece.board_pos.y + add};
-            if(current_move.x < 0 || current_move.x > BOARD_X_SIZE - 1  || current_move.y < 0 || current_move.y > BOARD_Y_SIZE - 1)
-                continue;
-            chess_piece current_piece = get_chess_piece_by_board_pos(current_move);
-            if(!is_chess_piece_move_possible(current_move) && current_piece.is_white == piece.is_white) 
-                break;
-            available_moves[moves_count++] = current_move;
-            if(!is_chess_piece_move_possible(current_move) && current_piece.is_white != piece.is_white) 
-                break;
-        }
-    return moves_count;
-}
+/* ============================ */
+/*        CHESS GAME API        */
+/* ============================ */
 
-vec2 get_king_position(bool8 is_white) {
-    for(u32 i = 0; i < board_data.piece_count; i++) {
-        if(board_data.pieces[i].is_white == is_white && board_data.pieces[i].type == chess_piece_type_king) 
-            return board_data.pieces[i].board_pos;
-    }
-    return (vec2){-1.0f, -1.0f};
+void render_chess_board_bg() {
+    render_checkerboard((vec4){242 / 255.0f, 225 / 255.0f, 172 / 255.0f, 1.0f}, (vec4){13 / 255.0f, 115 / 255.0f, 40 / 255.0f, 1.0f},
+                        (vec2){WINDOW_WIDTH / 2.0f, WINDOW_HEIGHT / 2.0f}, (vec2){WINDOW_WIDTH, WINDOW_HEIGHT}, WINDOW_WIDTH / BOARD_X_SIZE);
+    flush_quad_batch();
 }
 
-
-bool8 is_king_in_check(bool8 white) {
-    for(u32 i = 0; i < board_data.piece_count; i++) { 
-        vec2 available_moves_for_piece[96];
-        u32 available_moves_for_piece_count = get_available_moves_from_chess_piece(board_data.pieces[i], available_moves_for_piece);
-        for(u32 j = 0; j < available_moves_for_piece_count; j++) {
-            if((available_moves_for_piece[j].x == get_king_position(white).x && 
-                available_moves_for_piece[j].y == get_king_position(white).y)) {
-                return true;
-            }
-        }
+void render_chess_pieces_on_board(const chess_game* game) {
+    u32 piece_count = get_chess_piece_count(game);
+    for (u32 i = 0; i < piece_count; i++) {
+        chess_piece piece = get_chess_piece_by_index(game, i);
+        render_quad(piece.type, (vec4){1.0f, 1.0f, 1.0f, 1.0f}, (vec2){((WINDOW_WIDTH / BOARD_Y_SIZE) / 2) + WINDOW_HEIGHT / BOARD_X_SIZE * piece.board_pos.x, ((WINDOW_WIDTH / BOARD_Y_SIZE) / 2) + WINDOW_WIDTH / BOARD_Y_SIZE * piece.board_pos.y}, (vec2){WINDOW_HEIGHT / BOARD_X_SIZE, WINDOW_WIDTH / BOARD_Y_SIZE}, piece.is_white);
     }
-    return false;
-}
-bool8 is_king_in_check_after_move(vec2 src_move, vec2 dst_move, bool8 white) {
-    for(u32 i = 0; i < board_data.piece_count; i++) {
-        if(board_data.pieces[i].board_pos.x == src_move.x &&
-            board_data.pieces[i].board_pos.y == src_move.y) {
-            board_data.pieces[i].board_pos = dst_move;
-            bool8 ret = is_king_in_check(!white);
-            board_data.pieces[i].board_pos = src_move;
-            return ret;
-        }
-    }
-    return false;
-}
-
-u32 get_available_moves_from_chess_piece(chess_piece piece, vec2* available_moves) {
-    u32 moves_count = 0;
-    if (piece.type == chess_piece_type_pawn) {
-        if (piece.is_white) {
-            if (is_chess_piece_move_possible((vec2){piece.board_pos.x, piece.board_pos.y - 1.0f})) {
-                available_moves[moves_count++] = (vec2){piece.board_pos.x, piece.board_pos.y - 1.0f};
-                if (!piece.pawn_moved) {
-                    if (is_chess_piece_move_possible((vec2){piece.board_pos.x, piece.board_pos.y - 2.0f}))
-                        available_moves[moves_count++] = (vec2){piece.board_pos.x, piece.board_pos.y - 2.0f};
-                }
-            }
-            chess_piece diagonal_left_neighbour = get_chess_piece_by_board_pos((vec2){piece.board_pos.x - 1.0f, piece.board_pos.y - 1.0f});
-            if (diagonal_left_neighbour.type != chess_piece_type_none && !diagonal_left_neighbour.is_white) {
-                available_moves[moves_count++] = diagonal_left_neighbour.board_pos;
-            }
-
-            chess_piece diagonal_right_neighbour = get_chess_piece_by_board_pos((vec2){piece.board_pos.x + 1.0f, piece.board_pos.y - 1.0f});
-            if (diagonal_right_neighbour.type != chess_piece_type_none && !diagonal_right_neighbour.is_white) {
-                available_moves[moves_count++] = diagonal_right_neighbour.board_pos;
-            }
-        } else {
-            if (is_chess_piece_move_possible((vec2){piece.board_pos.x, piece.board_pos.y + 1.0f})) {
-                available_moves[moves_count++] = (vec2){piece.board_pos.x, piece.board_pos.y + 1.0f};
-                if (!piece.pawn_moved) {
-                    if (is_chess_piece_move_possible((vec2){piece.board_pos.x, piece.board_pos.y + 2.0f}))
-                        available_moves[moves_count++] = (vec2){piece.board_pos.x, piece.board_pos.y + 2.0f};
-                }
-            }
-
-            chess_piece diagonal_left_neighbour = get_chess_piece_by_board_pos((vec2){piece.board_pos.x - 1.0f, piece.board_pos.y + 1.0f});
-            if (diagonal_left_neighbour.type != chess_piece_type_none && diagonal_left_neighbour.is_white) {
-                available_moves[moves_count++] = diagonal_left_neighbour.board_pos;
-            }
-
-            chess_piece diagonal_right_neighbour = get_chess_piece_by_board_pos((vec2){piece.board_pos.x + 1.0f, piece.board_pos.y + 1.0f});
-            if (diagonal_right_neighbour.type != chess_piece_type_none && diagonal_right_neighbour.is_white) {
-                available_moves[moves_count++] = diagonal_right_neighbour.board_pos;
-            }
-        }
-    } else if (piece.type == chess_piece_type_rook) {
-        moves_count = get_straight_full_board_moves(piece, available_moves);
-    } else if(piece.type == chess_piece_type_bishop) {
-        moves_count = get_diagonal_full_board_moves(piece, available_moves);
-    } else if(piece.type == chess_piece_type_queen) {
-        moves_count = get_straight_full_board_moves(piece, available_moves); 
-        for(u32 add = 1; add < BOARD_X_SIZE; add++) { 
-            vec2 current_move = (vec2){piece.board_pos.x - add, piece.board_pos.y - add};
-            if(current_move.x < 0 || current_move.x > BOARD_X_SIZE - 1  || current_move.y < 0 || current_move.y > BOARD_Y_SIZE - 1)
-                continue;
-            chess_piece current_piece = get_chess_piece_by_board_pos(current_move);
-            if(!is_chess_piece_move_possible(current_move) && current_piece.is_white == piece.is_white) 
-                break;
-            available_moves[moves_count++] = current_move;
-            if(!is_chess_piece_move_possible(current_move) && current_piece.is_white != piece.is_white)
-                break;
-        }
-        for(u32 add = 1; add < BOARD_X_SIZE; add++) {
-            vec2 current_move = (vec2){piece.board_pos.x + add, piece.board_pos.y - add};
-            if(current_move.x < 0 || current_move.x > BOARD_X_SIZE - 1  || current_move.y < 0 || current_move.y > BOARD_Y_SIZE - 1)
-                continue;
-            chess_piece current_piece = get_chess_piece_by_board_pos(current_move);
-            if(!is_chess_piece_move_possible(current_move) && current_piece.is_white == piece.is_white) 
-                break;
-            available_moves[moves_count++] = current_move;
-            if(!is_chess_piece_move_possible(current_move) && current_piece.is_white != piece.is_white) 
-                break;
-        }
-        for(u32 add = 1; add < BOARD_X_SIZE; add++) {
-            vec2 current_move = (vec2){piece.board_pos.x - add, piece.board_pos.y + add};
-            if(current_move.x < 0 || current_move.x > BOARD_X_SIZE - 1  || current_move.y < 0 || current_move.y > BOARD_Y_SIZE - 1)
-                continue;
-            chess_piece current_piece = get_chess_piece_by_board_pos(current_move);
-            if(!is_chess_piece_move_possible(current_move) && current_piece.is_white == piece.is_white) 
-                break;
-            available_moves[moves_count++] = current_move;
-            if(!is_chess_piece_move_possible(current_move) && current_piece.is_white != piece.is_white) 
-                break;
-        }
-        for(u32 add = 1; add < BOARD_X_SIZE; add++) {
-            vec2 current_move = (vec2){piece.board_pos.x + add, piece.board_pos.y + add};
-            if(current_move.x < 0 || current_move.x > BOARD_X_SIZE - 1  || current_move.y < 0 || current_move.y > BOARD_Y_SIZE - 1)
-                continue;
-            chess_piece current_piece = get_chess_piece_by_board_pos(current_move);
-            if(!is_chess_piece_move_possible(current_move) && current_piece.is_white == piece.is_white) 
-                break;
-            available_moves[moves_count++] = current_move;
-            if(!is_chess_piece_move_possible(current_move) && current_piece.is_white != piece.is_white) 
-                break;
-        }
-    } else if(piece.type == chess_piece_type_king) {
-        for(i32 x = -1; x <= 1; x++) {
-            for(i32 y = -1; y <= 1; y++) {
-                vec2 current_move = (vec2){piece.board_pos.x + x, piece.board_pos.y + y};
-                if(current_move.x < 0 || current_move.x > BOARD_X_SIZE - 1  || current_move.y < 0 || current_move.y > BOARD_Y_SIZE - 1)
-                    continue;
-                chess_piece current_piece = get_chess_piece_by_board_pos(current_move);
-                if(!is_chess_piece_move_possible(current_move) && current_piece.is_white == piece.is_white) 
-                    continue; 
-                available_moves[moves_count++] = current_move;
-                if(!is_chess_piece_move_possible(current_move) && current_piece.is_white != piece.is_white) 
-                    continue;
-
-            }
-        }
-    } else if(piece.type == chess_piece_type_knight) {
-        if(get_chess_piece_by_board_pos((vec2){piece.board_pos.x - 2.0f, piece.board_pos.y - 1.0f}).is_white != piece.is_white 
-            || is_chess_piece_move_possible((vec2){piece.board_pos.x - 2.0f, piece.board_pos.y - 1.0f})) {
-            available_moves[moves_count++] = (vec2){piece.board_pos.x - 2.0f, piece.board_pos.y - 1.0f};
-        }
-        if(get_chess_piece_by_board_pos((vec2){piece.board_pos.x - 1.0f, piece.board_pos.y - 2.0f}).is_white != piece.is_white 
-            || is_chess_piece_move_possible((vec2){piece.board_pos.x - 1.0f, piece.board_pos.y - 2.0f})) {
-            available_moves[moves_count++] = (vec2){piece.board_pos.x - 1.0f, piece.board_pos.y - 2.0f};
-        }
-        if(get_chess_piece_by_board_pos((vec2){piece.board_pos.x + 2.0f, piece.board_pos.y - 1.0f}).is_white != piece.is_white 
-            || is_chess_piece_move_possible((vec2){piece.board_pos.x + 2.0f, piece.board_pos.y - 1.0f})) {
-            available_moves[moves_count++] = (vec2){piece.board_pos.x + 2.0f, piece.board_pos.y - 1.0f};
-        }
-        if(get_chess_piece_by_board_pos((vec2){piece.board_pos.x + 1.0f, piece.board_pos.y - 2.0f}).is_white != piece.is_white
-            || is_chess_piece_move_possible((vec2){piece.board_pos.x + 1.0f, piece.board_pos.y - 2.0f})) {
-            available_moves[moves_count++] = (vec2){piece.board_pos.x + 1.0f, piece.board_pos.y - 2.0f};
-        }
-        if(get_chess_piece_by_board_pos((vec2){piece.board_pos.x - 2.0f, piece.board_pos.y + 1.0f}).is_white != piece.is_white 
-            || is_chess_piece_move_possible((vec2){piece.board_pos.x - 2.0f, piece.board_pos.y + 1.0f})) {
-            available_moves[moves_count++] = (vec2){piece.board_pos.x - 2.0f, piece.board_pos.y + 1.0f};
-        }
-        if(get_chess_piece_by_board_pos((vec2){piece.board_pos.x - 1.0f, piece.board_pos.y + 2.0f}).is_white != piece.is_white
-            || is_chess_piece_move_possible((vec2){piece.board_pos.x - 1.0f, piece.board_pos.y + 2.0f})) {
-            available_moves[moves_count++] = (vec2){piece.board_pos.x - 1.0f, piece.board_pos.y + 2.0f};
-        }
-        if(get_chess_piece_by_board_pos((vec2){piece.board_pos.x + 2.0f, piece.board_pos.y + 1.0f}).is_white != piece.is_white
-            || is_chess_piece_move_possible((vec2){piece.board_pos.x + 2.0f, piece.board_pos.y + 1.0f})) {
-            available_moves[moves_count++] = (vec2){piece.board_pos.x + 2.0f, piece.board_pos.y + 1.0f};
-        }
-        if(get_chess_piece_by_board_pos((vec2){piece.board_pos.x + 1.0f, piece.board_pos.y + 2.0f}).is_white != piece.is_white
-            || is_chess_piece_move_possible((vec2){piece.board_pos.x + 1.0f, piece.board_pos.y + 2.0f})) {
-            available_moves[moves_count++] = (vec2){piece.board_pos.x + 1.0f, piece.board_pos.y + 2.0f};
-        }
-
-
-    }
-    return moves_count;
+    flush_quad_batch();
 }
 
-
-void remove_chess_piece_from_board(vec2 board_pos) {
-    u32 index = 0;
-    for (u32 i = 0; i < board_data.piece_count; i++) {
-        if (board_data.pieces[i].board_pos.x == board_pos.x && board_data.pieces[i].board_pos.y == board_pos.y) {
-            index = i;
-        }
-    }
-
-    for (u32 i = index; i < board_data.piece_count - 1; i++) {
-        board_data.pieces[i] = board_data.pieces[i + 1];
-    }
-
-    board_data.piece_count--;
+void render_quad_on_chess_board(vec4 color, vec2 board_pos, float scaling) {
+    render_quad_color(color, (vec2){((WINDOW_WIDTH / BOARD_X_SIZE) / 2) + WINDOW_WIDTH / BOARD_X_SIZE * board_pos.x, ((WINDOW_HEIGHT / BOARD_Y_SIZE) / 2) + WINDOW_HEIGHT / BOARD_Y_SIZE * board_pos.y}, (vec2){(WINDOW_WIDTH / BOARD_X_SIZE) * scaling, (WINDOW_HEIGHT / BOARD_Y_SIZE) * scaling});
 }
@@ -2,6 +2,7 @@
 
 #include <SDL2/SDL.h>
 #include "types.h"
+#include "chess_rules.h"
 
 /* ============================ */
 /*           GLOBALS            */
@@ -26,6 +27,12 @@ void sdl_setup_window(const char* window_title);
 /*   APPLICATION STRUCTURE API  */
 /* ============================ */
 
+/* CHESS_RENDER_MODE=event blocks until an event arrives and only redraws when it changed the screen */
+typedef enum {
+    render_mode_continuous = 0,
+    render_mode_event_driven
+} render_mode;
+
 void application_loop();
 
 void application_terminate();
@@ -34,10 +41,23 @@ void application_terminate();
 /*      OPENGL SHADER API       */
 /* ============================ */
 
+#define OPENGL_UNIFORM_NAME_LENGTH 64
+
+typedef struct {
+    char name[OPENGL_UNIFORM_NAME_LENGTH];
+    i32 location;
+} opengl_shader_uniform;
+
+/* the active uniforms and their locations are cached when the program is linked */
 typedef struct {
     u32 id;
+    u32 uniform_count;
+    opengl_shader_uniform* uniforms;
 } opengl_shader;
 
+/* uniform location handle, -1 when the program has no such uniform */
+typedef i32 opengl_uniform;
+
 opengl_shader opengl_shader_create(const char* vertex_path, const char* fragment_path);
 
 void opengl_shader_bind(opengl_shader shader);
@@ -46,6 +66,22 @@ void opengl_shader_unbind();
 
 void opengl_shader_delete(opengl_shader shader);
 
+opengl_uniform opengl_shader_get_uniform(opengl_shader shader, const char* name);
+
+/* handle based uploads to the bound program */
+void opengl_uniform_upload_int(opengl_uniform uniform, int i);
+
+void opengl_uniform_upload_float(opengl_uniform uniform, float f);
+
+void opengl_uniform_upload_vec2(opengl_uniform uniform, vec2 v);
+
+void opengl_uniform_upload_vec3(opengl_uniform uniform, vec3 v);
+
+void opengl_uniform_upload_vec4(opengl_uniform uniform, vec4 v);
+
+void opengl_uniform_upload_mat4(opengl_uniform uniform, mat4 m);
+
+/* slow path, looks the name up in the uniform cache on every call */
 void opengl_shader_upload_int(opengl_shader shader, int i, const char* name);
 
 void opengl_shader_upload_float(opengl_shader shader, float f, const char* name);
@@ -91,62 +127,69 @@ subtexture subtexture_create(opengl_texture texture, vec2 coords, vec2 cell_size
 subtexture_coords subtexture_get_texcoords(subtexture texture);
 
 /* ============================ */
-/*         RENDERER API         */
+/*   OPENGL STREAM BUFFER API   */
 /* ============================ */
 
-void init_quad_renderer();
+#define STREAM_BUFFER_REGIONS 3
 
-void terminate_quad_renderer();
+/* persistently mapped ring of regions, each fenced once the GPU commands reading it are issued */
+typedef struct {
+    u32 id;
+    u8* mapped;
+    u32 region_size;
+    u32 region;
+    u32 offset;
+    void* fences[STREAM_BUFFER_REGIONS];
+} opengl_stream_buffer;
 
-void render_quad(vec2 uv, vec4 color, vec2 pos, vec2 scale);
+opengl_stream_buffer opengl_stream_buffer_create(u32 region_size);
 
-void render_quad_color(vec4 color, vec2 pos, vec2 scale);
+void opengl_stream_buffer_delete(opengl_stream_buffer* buffer);
+
+/* returns mapped memory for size bytes of the current region and its buffer offset, NULL when the region is full */
+void* opengl_stream_buffer_alloc(opengl_stream_buffer* buffer, u32 size, u32* offset);
+
+/* fences the current region and waits until the GPU is done with the next one */
+void opengl_stream_buffer_next_region(opengl_stream_buffer* buffer);
 
 /* ============================ */
-/*        CHESS GAME API        */
+/*         RENDERER API         */
 /* ============================ */
 
-typedef enum {
-    chess_piece_type_none = 0,
-    chess_piece_type_pawn,
-    chess_piece_type_bishop,
-    chess_piece_type_knight,
-    chess_piece_type_rook,
-    chess_piece_type_queen,
-    chess_piece_type_king
-} chess_piece_type;
+/* instances per frame, one stream buffer region */
+#define MAX_QUAD_INSTANCES 1024
 
 typedef struct {
-    chess_piece_type type;
-    vec2 board_pos;
-    bool8 is_white;
-    bool8 pawn_moved;
-} chess_piece;
-
-void render_chess_board_bg();
-
-void init_chess_board();
+    u32 draw_calls;
+    u32 quads;
+} render_frame_stats;
 
-void destroy_chess_board();
+void init_quad_renderer();
 
-void chess_board_default_placement();
+void terminate_quad_renderer();
 
-void add_chess_piece_to_board(vec2 pos, chess_piece_type type, bool8 is_white);
+void begin_render_frame();
 
-void move_chess_piece_on_board(vec2 src_pos, vec2 dst_pos);
+render_frame_stats get_render_frame_stats();
 
-chess_piece get_chess_piece_by_board_pos(vec2 board_pos);
+/* quads are collected until flush_quad_batch() (or a full batch) and drawn with one instanced call */
+/* the sprite's uv rect comes from a table built once from the spritesheet, indexed by piece type */
+void render_quad(chess_piece_type sprite, vec4 color, vec2 pos, vec2 scale, bool8 white_piece);
 
-void render_chess_pieces_on_board();
+void render_quad_color(vec4 color, vec2 pos, vec2 scale);
 
-void render_quad_on_chess_board(vec4 color, vec2 board_pos, float scaling);
+/* one quad whose fragments pick the light or dark color from their window position,
+   the bottom left square_size square is light */
+void render_checkerboard(vec4 light_color, vec4 dark_color, vec2 pos, vec2 scale, float square_size);
 
-u32 get_available_moves_from_chess_piece(chess_piece piece, vec2* available_moves);
+void flush_quad_batch();
 
-void remove_chess_piece_from_board(vec2 board_pos);
+/* ============================ */
+/*        CHESS GAME API        */
+/* ============================ */
 
-bool8 is_king_in_check(bool8 white);
+void render_chess_board_bg();
 
-bool8 is_king_in_check_after_move(vec2 src_move, vec2 dst_move, bool8 white);
+void render_chess_pieces_on_board(const chess_game* game);
 
-vec2 get_king_position(bool8 white);
+void render_quad_on_chess_board(vec4 color, vec2 board_pos, float scaling);
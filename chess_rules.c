@@ -0,0 +1,1505 @@
+#include "chess_rules.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define CHESS_PEXT_AVAILABLE
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+/* ============================ */
+/*           GLOBALS            */
+/* ============================ */
+
+typedef u64 bitboard;
+
+typedef struct {
+    bitboard pieces[2][6];
+    bitboard occupancy[2];
+    bitboard occupied;
+    u8 mailbox[BOARD_SQUARE_COUNT];
+    u8 piece_squares[BOARD_SQUARE_COUNT];
+    u8 piece_index[BOARD_SQUARE_COUNT];
+    u8 piece_count;
+    bool8 white_turn;
+    u8 castling_rights;
+    u8 en_passant_square;
+    u16 halfmove_clock;
+    u16 fullmove_number;
+    u64 key;
+} chess_board;
+
+typedef struct {
+    chess_move move;
+    u8 captured;
+    u8 castling_rights;
+    u8 en_passant_square;
+    u16 halfmove_clock;
+    u64 key;
+} chess_undo;
+
+typedef struct {
+    chess_undo moves[MAX_GAME_PLY];
+    u32 count;
+} move_history;
+
+struct chess_game {
+    chess_board board;
+    move_history history;
+    chess_game_status status;
+    bool8 status_valid;
+};
+
+#define MAILBOX_EMPTY 0
+#define MAILBOX_WHITE_BIT 0x8
+#define MAILBOX_TYPE_MASK 0x7
+
+#define BITBOARD_RANK_1 0x00000000000000FFULL
+#define BITBOARD_RANK_2 0x000000000000FF00ULL
+#define BITBOARD_RANK_7 0x00FF000000000000ULL
+#define BITBOARD_RANK_8 0xFF00000000000000ULL
+
+#define NO_SQUARE 64
+
+#define CASTLE_WHITE_KING_SIDE 0x1
+#define CASTLE_WHITE_QUEEN_SIDE 0x2
+#define CASTLE_BLACK_KING_SIDE 0x4
+#define CASTLE_BLACK_QUEEN_SIDE 0x8
+#define CASTLE_ALL 0xF
+
+/* ============================ */
+/*       ZOBRIST HASHING        */
+/* ============================ */
+
+typedef struct {
+    u64 pieces[2][6][BOARD_SQUARE_COUNT];
+    u64 castling[CASTLE_ALL + 1];
+    u64 en_passant_file[BOARD_X_SIZE];
+    u64 white_turn;
+} zobrist_table;
+
+static zobrist_table zobrist_keys;
+
+static u64 zobrist_next_random(u64* state) {
+    u64 z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static void init_zobrist_keys() {
+    u64 state = 0x2545F4914F6CDD1DULL;
+    for (u32 color = 0; color < 2; color++) {
+        for (u32 type = 0; type < 6; type++) {
+            for (u32 square = 0; square < BOARD_SQUARE_COUNT; square++) {
+                zobrist_keys.pieces[color][type][square] = zobrist_next_random(&state);
+            }
+        }
+    }
+    for (u32 rights = 1; rights <= CASTLE_ALL; rights++) {
+        zobrist_keys.castling[rights] = zobrist_next_random(&state);
+    }
+    for (u32 file = 0; file < BOARD_X_SIZE; file++) {
+        zobrist_keys.en_passant_file[file] = zobrist_next_random(&state);
+    }
+    zobrist_keys.white_turn = zobrist_next_random(&state);
+}
+
+static u64 board_compute_zobrist_key(const chess_board* board) {
+    u64 key = zobrist_keys.castling[board->castling_rights];
+    for (u32 i = 0; i < board->piece_count; i++) {
+        u32 square = board->piece_squares[i];
+        u8 code = board->mailbox[square];
+        key ^= zobrist_keys.pieces[(code & MAILBOX_WHITE_BIT) != 0][(code & MAILBOX_TYPE_MASK) - 1][square];
+    }
+    if (board->en_passant_square != NO_SQUARE) {
+        key ^= zobrist_keys.en_passant_file[board->en_passant_square % BOARD_X_SIZE];
+    }
+    if (board->white_turn) {
+        key ^= zobrist_keys.white_turn;
+    }
+    return key;
+}
+
+/* ============================ */
+/*    BITBOARD ATTACK TABLES    */
+/* ============================ */
+
+typedef struct {
+    bitboard mask;
+    bitboard magic;
+    bitboard* magic_attacks;
+    bitboard* pext_attacks;
+    u32 shift;
+} slider_table;
+
+static const bitboard rook_magic_numbers[BOARD_SQUARE_COUNT] = {
+    0x1080004008801020ULL, 0x0840092002C03000ULL, 0x1900200010400900ULL, 0x0880100008000480ULL,
+    0x4200100420080200ULL, 0x8100020100080400ULL, 0x0200040110886200ULL, 0x0200008040220411ULL,
+    0x0404800084400220ULL, 0x0000401000402000ULL, 0x0086001081220440ULL, 0x0408800800100280ULL,
+    0x000A001201040820ULL, 0x8848800200840080ULL, 0x4001000100040200ULL, 0x0442000102105084ULL,
+    0x9080010020804100ULL, 0x0040404000201009ULL, 0x0000808010002009ULL, 0x2200090021D00100ULL,
+    0x0008008008040080ULL, 0x0004004002010040ULL, 0x0011040008015042ULL, 0x00000A0001768104ULL,
+    0x0000800080204009ULL, 0x2010004140002001ULL, 0x9800200280100080ULL, 0x1000100080080080ULL,
+    0x0442000A00049020ULL, 0x2100040080020080ULL, 0x0800120400900148ULL, 0x0010040A00128541ULL,
+    0x2800804000800030ULL, 0x1010002000400041ULL, 0x4000200011004100ULL, 0x0610008410800800ULL,
+    0x0400802402800800ULL, 0xC100020080800400ULL, 0x0002000802000401ULL, 0x0182085882000401ULL,
+    0x0220204000808000ULL, 0x2860100040024022ULL, 0x0001002004110040ULL, 0x99101042000A0020ULL,
+    0x0004080004008080ULL, 0x0010040002008080ULL, 0x2012004881020004ULL, 0x8300842444820011ULL,
+    0x0088403882010200ULL, 0x0820400080210100ULL, 0x0110910040A00300ULL, 0x0801100280080480ULL,
+    0x0242009008200600ULL, 0x1002000489500200ULL, 0x0040800200010080ULL, 0x0091800041000080ULL,
+    0x0000209300488001ULL, 0x04C1002414824001ULL, 0x020020000B001041ULL, 0x7000100004200901ULL,
+    0x8002002004100802ULL, 0x30010002084C0007ULL, 0x0888221800813004ULL, 0x4000002840840112ULL};
+
+static const bitboard bishop_magic_numbers[BOARD_SQUARE_COUNT] = {
+    0xA010041108003100ULL, 0x006082020A002900ULL, 0x6810010619200000ULL, 0x08281A0520000408ULL,
+    0x0001104001000400ULL, 0x0018901008048400ULL, 0x00040A0210245280ULL, 0x000200210808A402ULL,
+    0x9140048410821200ULL, 0x0800091010820041ULL, 0x20504804832202C0ULL, 0x0100091401081000ULL,
+    0x8021011140000012ULL, 0x0810020804450400ULL, 0x208B0542109008A2ULL, 0x0080084A08040204ULL,
+    0x0040E2A80811244CULL, 0x2505022008008108ULL, 0x0430220100420040ULL, 0x010A040420220040ULL,
+    0x1105000290400000ULL, 0x0093001200822120ULL, 0x4000A62048043004ULL, 0x280120048A015004ULL,
+    0x006090002A020814ULL, 0x44042000240800D0ULL, 0x01102800040A4400ULL, 0x1004080080220040ULL,
+    0x0001001011004024ULL, 0x0010044000805040ULL, 0x0914041200820100ULL, 0x0004821012821480ULL,
+    0x0024040500C05021ULL, 0x0088611002080200ULL, 0x0116080A00040020ULL, 0x4000020080080080ULL,
+    0x2450450140840040ULL, 0x0000880201484100ULL, 0x0222020404020092ULL, 0x8081110600002E00ULL,
+    0x2842101105000801ULL, 0x1100809008001025ULL, 0x00020202221C0400ULL, 0x0422014022009020ULL,
+    0x0210046102100C00ULL, 0xC004008082029102ULL, 0x00AA461801101200ULL, 0x0404080080201108ULL,
+    0x020542108C205002ULL, 0x0410544804100100ULL, 0x0040910841100000ULL, 0x0400200042021100ULL,
+    0x00004204850400C0ULL, 0x0200100410A42102ULL, 0x1040020801210102ULL, 0x0805040410420000ULL,
+    0x2884804130100200ULL, 0x800C262201242000ULL, 0x1058000194108800ULL, 0x0014221054420204ULL,
+    0x0104000012A02200ULL, 0x0200881003300100ULL, 0x0140400202840100ULL, 0x0402020801010201ULL};
+
+static const i32 pawn_offsets[2][2][2] = {{{-1, -1}, {1, -1}}, {{-1, 1}, {1, 1}}};
+static const i32 knight_offsets[8][2] = {{1, 2}, {2, 1}, {2, -1}, {1, -2}, {-1, -2}, {-2, -1}, {-2, 1}, {-1, 2}};
+static const i32 king_offsets[8][2] = {{0, 1}, {1, 1}, {1, 0}, {1, -1}, {0, -1}, {-1, -1}, {-1, 0}, {-1, 1}};
+static const i32 rook_directions[4][2] = {{0, 1}, {0, -1}, {1, 0}, {-1, 0}};
+static const i32 bishop_directions[4][2] = {{1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+
+static slider_table rook_tables[BOARD_SQUARE_COUNT];
+static slider_table bishop_tables[BOARD_SQUARE_COUNT];
+static bitboard pawn_attack_table[2][BOARD_SQUARE_COUNT];
+static bitboard knight_attack_table[BOARD_SQUARE_COUNT];
+static bitboard king_attack_table[BOARD_SQUARE_COUNT];
+static u8 castling_rights_mask[BOARD_SQUARE_COUNT];
+static bitboard between_table[BOARD_SQUARE_COUNT][BOARD_SQUARE_COUNT];
+static bitboard line_table[BOARD_SQUARE_COUNT][BOARD_SQUARE_COUNT];
+static bitboard rook_magic_attack_table[102400];
+static bitboard bishop_magic_attack_table[5248];
+static bitboard rook_pext_attack_table[102400];
+static bitboard bishop_pext_attack_table[5248];
+static pthread_once_t attack_tables_once = PTHREAD_ONCE_INIT;
+
+/* swapped atomically by set_slider_attack_backend, every backend reads the same immutable tables */
+static slider_attack_backend s_slider_backend;
+static bitboard (*rook_attacks_fn)(u32 square, bitboard occupied);
+static bitboard (*bishop_attacks_fn)(u32 square, bitboard occupied);
+
+static inline u32 bitboard_pop_lsb(bitboard* b) {
+    u32 square = __builtin_ctzll(*b);
+    *b &= *b - 1;
+    return square;
+}
+
+static bitboard slider_attacks_by_rays(u32 square, bitboard occupied, const i32 directions[4][2]) {
+    bitboard attacks = 0;
+    for (u32 i = 0; i < 4; i++) {
+        i32 x = square % BOARD_X_SIZE + directions[i][0];
+        i32 y = square / BOARD_X_SIZE + directions[i][1];
+        while (x >= 0 && x < BOARD_X_SIZE && y >= 0 && y < BOARD_Y_SIZE) {
+            bitboard bit = 1ULL << (y * BOARD_X_SIZE + x);
+            attacks |= bit;
+            if (occupied & bit) break;
+            x += directions[i][0];
+            y += directions[i][1];
+        }
+    }
+    return attacks;
+}
+
+static bitboard leaper_attacks(u32 square, const i32 offsets[][2], u32 offset_count) {
+    bitboard attacks = 0;
+    for (u32 i = 0; i < offset_count; i++) {
+        i32 x = square % BOARD_X_SIZE + offsets[i][0];
+        i32 y = square / BOARD_X_SIZE + offsets[i][1];
+        if (x >= 0 && x < BOARD_X_SIZE && y >= 0 && y < BOARD_Y_SIZE) {
+            attacks |= 1ULL << (y * BOARD_X_SIZE + x);
+        }
+    }
+    return attacks;
+}
+
+static bitboard slider_relevant_mask(u32 square, const i32 directions[4][2]) {
+    bitboard mask = 0;
+    for (u32 i = 0; i < 4; i++) {
+        i32 x = square % BOARD_X_SIZE + directions[i][0];
+        i32 y = square / BOARD_X_SIZE + directions[i][1];
+        while (x + directions[i][0] >= 0 && x + directions[i][0] < BOARD_X_SIZE &&
+               y + directions[i][1] >= 0 && y + directions[i][1] < BOARD_Y_SIZE) {
+            mask |= 1ULL << (y * BOARD_X_SIZE + x);
+            x += directions[i][0];
+            y += directions[i][1];
+        }
+    }
+    return mask;
+}
+
+static void init_slider_magic_tables(slider_table* tables, const bitboard* magic_numbers, const i32 directions[4][2], bitboard* table) {
+    for (u32 square = 0; square < BOARD_SQUARE_COUNT; square++) {
+        slider_table* t = &tables[square];
+        t->mask = slider_relevant_mask(square, directions);
+        t->magic = magic_numbers[square];
+        t->shift = 64 - __builtin_popcountll(t->mask);
+        t->magic_attacks = table;
+
+        bitboard subset = 0;
+        do {
+            t->magic_attacks[(subset * t->magic) >> t->shift] = slider_attacks_by_rays(square, subset, directions);
+            subset = (subset - t->mask) & t->mask;
+        } while (subset);
+        table += 1ULL << (64 - t->shift);
+    }
+}
+
+static bitboard rook_attacks_portable(u32 square, bitboard occupied) {
+    return slider_attacks_by_rays(square, occupied, rook_directions);
+}
+
+static bitboard bishop_attacks_portable(u32 square, bitboard occupied) {
+    return slider_attacks_by_rays(square, occupied, bishop_directions);
+}
+
+static bitboard rook_attacks_magic(u32 square, bitboard occupied) {
+    const slider_table* t = &rook_tables[square];
+    return t->magic_attacks[((occupied & t->mask) * t->magic) >> t->shift];
+}
+
+static bitboard bishop_attacks_magic(u32 square, bitboard occupied) {
+    const slider_table* t = &bishop_tables[square];
+    return t->magic_attacks[((occupied & t->mask) * t->magic) >> t->shift];
+}
+
+#ifdef CHESS_PEXT_AVAILABLE
+static bool8 cpu_has_fast_pext() {
+    u32 eax, ebx, ecx, edx;
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) || !(ebx & bit_BMI2)) return false;
+
+    /* AMD before Zen 3 implements PEXT in microcode, which is slower than a magic multiply */
+    __get_cpuid(0, &eax, &ebx, &ecx, &edx);
+    bool8 is_amd = ebx == 0x68747541 && edx == 0x69746E65 && ecx == 0x444D4163;
+    if (is_amd) {
+        __get_cpuid(1, &eax, &ebx, &ecx, &edx);
+        u32 family = ((eax >> 8) & 0xF) + ((eax >> 20) & 0xFF);
+        if (family < 0x19) return false;
+    }
+    return true;
+}
+
+__attribute__((target("bmi2")))
+static void init_slider_pext_tables(slider_table* tables, const i32 directions[4][2], bitboard* table) {
+    for (u32 square = 0; square < BOARD_SQUARE_COUNT; square++) {
+        slider_table* t = &tables[square];
+        t->pext_attacks = table;
+
+        bitboard subset = 0;
+        do {
+            t->pext_attacks[_pext_u64(subset, t->mask)] = slider_attacks_by_rays(square, subset, directions);
+            subset = (subset - t->mask) & t->mask;
+        } while (subset);
+        table += 1ULL << (64 - t->shift);
+    }
+}
+
+__attribute__((target("bmi2")))
+static bitboard rook_attacks_pext(u32 square, bitboard occupied) {
+    const slider_table* t = &rook_tables[square];
+    return t->pext_attacks[_pext_u64(occupied, t->mask)];
+}
+
+__attribute__((target("bmi2")))
+static bitboard bishop_attacks_pext(u32 square, bitboard occupied) {
+    const slider_table* t = &bishop_tables[square];
+    return t->pext_attacks[_pext_u64(occupied, t->mask)];
+}
+#endif
+
+static bool8 select_slider_attack_backend(slider_attack_backend backend) {
+    bitboard (*rook_fn)(u32 square, bitboard occupied);
+    bitboard (*bishop_fn)(u32 square, bitboard occupied);
+    switch (backend) {
+        case slider_attack_backend_portable:
+            rook_fn = rook_attacks_portable;
+            bishop_fn = bishop_attacks_portable;
+            break;
+        case slider_attack_backend_magic:
+            rook_fn = rook_attacks_magic;
+            bishop_fn = bishop_attacks_magic;
+            break;
+        case slider_attack_backend_pext:
+#ifdef CHESS_PEXT_AVAILABLE
+            if (!__builtin_cpu_supports("bmi2")) return false;
+            rook_fn = rook_attacks_pext;
+            bishop_fn = bishop_attacks_pext;
+            break;
+#else
+            return false;
+#endif
+        default:
+            return false;
+    }
+    __atomic_store_n(&rook_attacks_fn, rook_fn, __ATOMIC_RELAXED);
+    __atomic_store_n(&bishop_attacks_fn, bishop_fn, __ATOMIC_RELAXED);
+    __atomic_store_n(&s_slider_backend, backend, __ATOMIC_RELAXED);
+    return true;
+}
+
+static void build_attack_tables() {
+    for (u32 square = 0; square < BOARD_SQUARE_COUNT; square++) {
+        pawn_attack_table[false][square] = leaper_attacks(square, pawn_offsets[false], 2);
+        pawn_attack_table[true][square] = leaper_attacks(square, pawn_offsets[true], 2);
+        knight_attack_table[square] = leaper_attacks(square, knight_offsets, 8);
+        king_attack_table[square] = leaper_attacks(square, king_offsets, 8);
+        castling_rights_mask[square] = CASTLE_ALL;
+    }
+    castling_rights_mask[0] &= ~CASTLE_WHITE_QUEEN_SIDE;
+    castling_rights_mask[4] &= ~(CASTLE_WHITE_KING_SIDE | CASTLE_WHITE_QUEEN_SIDE);
+    castling_rights_mask[7] &= ~CASTLE_WHITE_KING_SIDE;
+    castling_rights_mask[56] &= ~CASTLE_BLACK_QUEEN_SIDE;
+    castling_rights_mask[60] &= ~(CASTLE_BLACK_KING_SIDE | CASTLE_BLACK_QUEEN_SIDE);
+    castling_rights_mask[63] &= ~CASTLE_BLACK_KING_SIDE;
+    for (u32 a = 0; a < BOARD_SQUARE_COUNT; a++) {
+        for (u32 b = 0; b < BOARD_SQUARE_COUNT; b++) {
+            bitboard bits = (1ULL << a) | (1ULL << b);
+            if (a == b) continue;
+            if (slider_attacks_by_rays(a, 0, rook_directions) & (1ULL << b)) {
+                between_table[a][b] = slider_attacks_by_rays(a, bits, rook_directions) & slider_attacks_by_rays(b, bits, rook_directions);
+                line_table[a][b] = (slider_attacks_by_rays(a, 0, rook_directions) & slider_attacks_by_rays(b, 0, rook_directions)) | bits;
+            } else if (slider_attacks_by_rays(a, 0, bishop_directions) & (1ULL << b)) {
+                between_table[a][b] = slider_attacks_by_rays(a, bits, bishop_directions) & slider_attacks_by_rays(b, bits, bishop_directions);
+                line_table[a][b] = (slider_attacks_by_rays(a, 0, bishop_directions) & slider_attacks_by_rays(b, 0, bishop_directions)) | bits;
+            }
+        }
+    }
+    init_slider_magic_tables(rook_tables, rook_magic_numbers, rook_directions, rook_magic_attack_table);
+    init_slider_magic_tables(bishop_tables, bishop_magic_numbers, bishop_directions, bishop_magic_attack_table);
+#ifdef CHESS_PEXT_AVAILABLE
+    if (__builtin_cpu_supports("bmi2")) {
+        init_slider_pext_tables(rook_tables, rook_directions, rook_pext_attack_table);
+        init_slider_pext_tables(bishop_tables, bishop_directions, bishop_pext_attack_table);
+    }
+#endif
+    init_zobrist_keys();
+
+    slider_attack_backend backend = slider_attack_backend_magic;
+#ifdef CHESS_PEXT_AVAILABLE
+    if (cpu_has_fast_pext()) backend = slider_attack_backend_pext;
+#endif
+    const char* requested = getenv("CHESS_SLIDER_BACKEND");
+    if (requested) {
+        for (u32 i = 0; i < slider_attack_backend_count; i++) {
+            if (strcmp(requested, get_slider_attack_backend_name(i)) == 0) backend = i;
+        }
+    }
+    if (!select_slider_attack_backend(backend)) {
+        select_slider_attack_backend(slider_attack_backend_magic);
+    }
+}
+
+static void init_attack_tables() {
+    pthread_once(&attack_tables_once, build_attack_tables);
+}
+
+bool8 set_slider_attack_backend(slider_attack_backend backend) {
+    init_attack_tables();
+    return select_slider_attack_backend(backend);
+}
+
+slider_attack_backend get_slider_attack_backend() {
+    init_attack_tables();
+    return __atomic_load_n(&s_slider_backend, __ATOMIC_RELAXED);
+}
+
+const char* get_slider_attack_backend_name(slider_attack_backend backend) {
+    switch (backend) {
+        case slider_attack_backend_portable: return "portable";
+        case slider_attack_backend_magic: return "magic";
+        case slider_attack_backend_pext: return "pext";
+        default: return "unknown";
+    }
+}
+
+static inline bitboard rook_attacks(u32 square, bitboard occupied) {
+    return __atomic_load_n(&rook_attacks_fn, __ATOMIC_RELAXED)(square, occupied);
+}
+
+static inline bitboard bishop_attacks(u32 square, bitboard occupied) {
+    return __atomic_load_n(&bishop_attacks_fn, __ATOMIC_RELAXED)(square, occupied);
+}
+
+/* ============================ */
+/*        CHESS GAME API        */
+/* ============================ */
+
+static void board_put_piece(chess_board* board, u32 square, chess_piece_type type, bool8 is_white) {
+    bitboard bit = 1ULL << square;
+    board->pieces[is_white][type - 1] |= bit;
+    board->occupancy[is_white] |= bit;
+    board->occupied |= bit;
+    board->mailbox[square] = type | (is_white ? MAILBOX_WHITE_BIT : 0);
+    board->key ^= zobrist_keys.pieces[is_white][type - 1][square];
+    board->piece_index[square] = board->piece_count;
+    board->piece_squares[board->piece_count++] = square;
+}
+
+static void board_clear_square(chess_board* board, u32 square) {
+    u8 code = board->mailbox[square];
+    if (code == MAILBOX_EMPTY) return;
+    bitboard bit = 1ULL << square;
+    bool8 is_white = (code & MAILBOX_WHITE_BIT) != 0;
+    board->pieces[is_white][(code & MAILBOX_TYPE_MASK) - 1] &= ~bit;
+    board->occupancy[is_white] &= ~bit;
+    board->occupied &= ~bit;
+    board->mailbox[square] = MAILBOX_EMPTY;
+    board->key ^= zobrist_keys.pieces[is_white][(code & MAILBOX_TYPE_MASK) - 1][square];
+
+    u8 index = board->piece_index[square];
+    u8 last_square = board->piece_squares[--board->piece_count];
+    board->piece_squares[index] = last_square;
+    board->piece_index[last_square] = index;
+}
+
+static void board_move_piece(chess_board* board, u32 src_square, u32 dst_square) {
+    u8 code = board->mailbox[src_square];
+    bitboard bits = (1ULL << src_square) | (1ULL << dst_square);
+    bool8 is_white = (code & MAILBOX_WHITE_BIT) != 0;
+    board->pieces[is_white][(code & MAILBOX_TYPE_MASK) - 1] ^= bits;
+    board->occupancy[is_white] ^= bits;
+    board->occupied ^= bits;
+    board->mailbox[src_square] = MAILBOX_EMPTY;
+    board->mailbox[dst_square] = code;
+    board->key ^= zobrist_keys.pieces[is_white][(code & MAILBOX_TYPE_MASK) - 1][src_square] ^
+                  zobrist_keys.pieces[is_white][(code & MAILBOX_TYPE_MASK) - 1][dst_square];
+
+    u8 index = board->piece_index[src_square];
+    board->piece_squares[index] = dst_square;
+    board->piece_index[dst_square] = index;
+}
+
+static void board_set_castling_rights(chess_board* board, u8 castling_rights) {
+    board->key ^= zobrist_keys.castling[board->castling_rights] ^ zobrist_keys.castling[castling_rights];
+    board->castling_rights = castling_rights;
+}
+
+static void board_set_en_passant_square(chess_board* board, u8 square) {
+    if (board->en_passant_square != NO_SQUARE) {
+        board->key ^= zobrist_keys.en_passant_file[board->en_passant_square % BOARD_X_SIZE];
+    }
+    if (square != NO_SQUARE) {
+        board->key ^= zobrist_keys.en_passant_file[square % BOARD_X_SIZE];
+    }
+    board->en_passant_square = square;
+}
+
+static void board_toggle_turn(chess_board* board) {
+    board->white_turn = !board->white_turn;
+    board->key ^= zobrist_keys.white_turn;
+}
+
+static chess_piece board_get_piece(const chess_board* board, u32 square) {
+    u8 code = board->mailbox[square];
+    chess_piece ret = {
+        .board_pos = square_to_board_pos(square),
+        .is_white = (code & MAILBOX_WHITE_BIT) != 0,
+        .type = (chess_piece_type)(code & MAILBOX_TYPE_MASK)};
+    if (ret.type == chess_piece_type_pawn) {
+        ret.pawn_moved = !((1ULL << square) & (ret.is_white ? BITBOARD_RANK_2 : BITBOARD_RANK_7));
+    }
+    return ret;
+}
+
+static const chess_piece_type promotion_types[4] = {
+    chess_piece_type_knight, chess_piece_type_bishop, chess_piece_type_rook, chess_piece_type_queen};
+
+chess_piece_type chess_move_promotion_type(chess_move move) {
+    if (!(chess_move_flags(move) & chess_move_flag_promotion)) return chess_piece_type_none;
+    return promotion_types[chess_move_flags(move) & 0x3];
+}
+
+void chess_move_to_string(chess_move move, char* buffer) {
+    static const char promotion_chars[4] = {'n', 'b', 'r', 'q'};
+    u32 from = chess_move_from(move);
+    u32 to = chess_move_to(move);
+    buffer[0] = 'a' + from % BOARD_X_SIZE;
+    buffer[1] = '1' + from / BOARD_X_SIZE;
+    buffer[2] = 'a' + to % BOARD_X_SIZE;
+    buffer[3] = '1' + to / BOARD_X_SIZE;
+    buffer[4] = '\0';
+    if (chess_move_flags(move) & chess_move_flag_promotion) {
+        buffer[4] = promotion_chars[chess_move_flags(move) & 0x3];
+        buffer[5] = '\0';
+    }
+}
+
+static u32 en_passant_captured_square(u32 to, bool8 white_moved) {
+    return white_moved ? to - BOARD_X_SIZE : to + BOARD_X_SIZE;
+}
+
+static void board_make_move(chess_board* board, chess_move move, chess_undo* undo) {
+    u32 from = chess_move_from(move);
+    u32 to = chess_move_to(move);
+    u32 flags = chess_move_flags(move);
+    u32 captured_square = flags == chess_move_flag_en_passant ? en_passant_captured_square(to, board->white_turn) : to;
+
+    undo->move = move;
+    undo->captured = board->mailbox[captured_square];
+    undo->castling_rights = board->castling_rights;
+    undo->en_passant_square = board->en_passant_square;
+    undo->halfmove_clock = board->halfmove_clock;
+    undo->key = board->key;
+
+    bool8 is_pawn_move = (board->mailbox[from] & MAILBOX_TYPE_MASK) == chess_piece_type_pawn;
+    board->halfmove_clock = (is_pawn_move || undo->captured != MAILBOX_EMPTY) ? 0 : board->halfmove_clock + 1;
+    board->fullmove_number += !board->white_turn;
+
+    if (undo->captured != MAILBOX_EMPTY) {
+        board_clear_square(board, captured_square);
+    }
+    board_move_piece(board, from, to);
+    if (flags & chess_move_flag_promotion) {
+        board_clear_square(board, to);
+        board_put_piece(board, to, promotion_types[flags & 0x3], board->white_turn);
+    } else if (flags == chess_move_flag_king_castle) {
+        board_move_piece(board, to + 1, to - 1);
+    } else if (flags == chess_move_flag_queen_castle) {
+        board_move_piece(board, to - 2, to + 1);
+    }
+
+    board_set_en_passant_square(board, flags == chess_move_flag_double_push ? (from + to) / 2 : NO_SQUARE);
+    board_set_castling_rights(board, board->castling_rights & castling_rights_mask[from] & castling_rights_mask[to]);
+    board_toggle_turn(board);
+}
+
+static void board_unmake_move(chess_board* board, const chess_undo* undo) {
+    u32 from = chess_move_from(undo->move);
+    u32 to = chess_move_to(undo->move);
+    u32 flags = chess_move_flags(undo->move);
+
+    board->white_turn = !board->white_turn;
+    board->castling_rights = undo->castling_rights;
+    board->en_passant_square = undo->en_passant_square;
+    board->halfmove_clock = undo->halfmove_clock;
+    board->fullmove_number -= !board->white_turn;
+
+    if (flags & chess_move_flag_promotion) {
+        board_clear_square(board, to);
+        board_put_piece(board, to, chess_piece_type_pawn, board->white_turn);
+    } else if (flags == chess_move_flag_king_castle) {
+        board_move_piece(board, to - 1, to + 1);
+    } else if (flags == chess_move_flag_queen_castle) {
+        board_move_piece(board, to + 1, to - 2);
+    }
+    board_move_piece(board, to, from);
+    if (undo->captured != MAILBOX_EMPTY) {
+        u32 captured_square = flags == chess_move_flag_en_passant ? en_passant_captured_square(to, board->white_turn) : to;
+        board_put_piece(board, captured_square, undo->captured & MAILBOX_TYPE_MASK, (undo->captured & MAILBOX_WHITE_BIT) != 0);
+    }
+    board->key = undo->key;
+}
+
+chess_game* chess_game_create() {
+    init_attack_tables();
+    chess_game* game = calloc(1, sizeof(chess_game));
+    if (!game) return NULL;
+    game->board.en_passant_square = NO_SQUARE;
+    game->board.fullmove_number = 1;
+    return game;
+}
+
+void chess_board_default_placement(chess_game* game) {
+    memset(&game->board, 0, sizeof(game->board));
+    game->board.en_passant_square = NO_SQUARE;
+    game->history.count = 0;
+
+    add_chess_piece_to_board(game, (vec2){0.0f, 0.0f}, chess_piece_type_rook, false);
+    add_chess_piece_to_board(game, (vec2){1.0f, 0.0f}, chess_piece_type_knight, false);
+    add_chess_piece_to_board(game, (vec2){2.0f, 0.0f}, chess_piece_type_bishop, false);
+    add_chess_piece_to_board(game, (vec2){3.0f, 0.0f}, chess_piece_type_queen, false);
+    add_chess_piece_to_board(game, (vec2){4.0f, 0.0f}, chess_piece_type_king, false);
+    add_chess_piece_to_board(game, (vec2){5.0f, 0.0f}, chess_piece_type_bishop, false);
+    add_chess_piece_to_board(game, (vec2){6.0f, 0.0f}, chess_piece_type_knight, false);
+    add_chess_piece_to_board(game, (vec2){7.0f, 0.0f}, chess_piece_type_rook, false);
+    for (u32 x = 0; x < 8; x++) {
+        add_chess_piece_to_board(game, (vec2){x, 1.0f}, chess_piece_type_pawn, false);
+    }
+    add_chess_piece_to_board(game, (vec2){0.0f, 7.0f}, chess_piece_type_rook, true);
+    add_chess_piece_to_board(game, (vec2){1.0f, 7.0f}, chess_piece_type_knight, true);
+    add_chess_piece_to_board(game, (vec2){2.0f, 7.0f}, chess_piece_type_bishop, true);
+    add_chess_piece_to_board(game, (vec2){3.0f, 7.0f}, chess_piece_type_queen, true);
+    add_chess_piece_to_board(game, (vec2){4.0f, 7.0f}, chess_piece_type_king, true);
+    add_chess_piece_to_board(game, (vec2){5.0f, 7.0f}, chess_piece_type_bishop, true);
+    add_chess_piece_to_board(game, (vec2){6.0f, 7.0f}, chess_piece_type_knight, true);
+    add_chess_piece_to_board(game, (vec2){7.0f, 7.0f}, chess_piece_type_rook, true);
+    for (u32 x = 0; x < 8; x++) {
+        add_chess_piece_to_board(game, (vec2){x, 6.0f}, chess_piece_type_pawn, true);
+    }
+    board_toggle_turn(&game->board);
+    board_set_castling_rights(&game->board, CASTLE_ALL);
+    game->board.fullmove_number = 1;
+    game->status_valid = false;
+}
+
+bool8 is_white_turn(const chess_game* game) {
+    return game->board.white_turn;
+}
+
+u64 get_chess_position_key(const chess_game* game) {
+    return game->board.key;
+}
+
+u64 compute_chess_position_key(const chess_game* game) {
+    return board_compute_zobrist_key(&game->board);
+}
+void chess_game_destroy(chess_game* game) {
+    free(game);
+}
+void add_chess_piece_to_board(chess_game* game, vec2 pos, chess_piece_type type, bool8 is_white) {
+    if (!is_board_pos_on_board(pos) || type == chess_piece_type_none) return;
+    u32 square = board_pos_to_square(pos);
+    board_clear_square(&game->board, square);
+    board_put_piece(&game->board, square, type, is_white);
+    board_set_castling_rights(&game->board, game->board.castling_rights & castling_rights_mask[square]);
+    game->status_valid = false;
+}
+
+void move_chess_piece_on_board(chess_game* game, vec2 src_pos, vec2 dst_pos) {
+    if (!is_board_pos_on_board(src_pos) || !is_board_pos_on_board(dst_pos)) return;
+    u32 src_square = board_pos_to_square(src_pos);
+    u32 dst_square = board_pos_to_square(dst_pos);
+    if (game->board.mailbox[src_square] == MAILBOX_EMPTY || src_square == dst_square) return;
+    board_clear_square(&game->board, dst_square);
+    board_move_piece(&game->board, src_square, dst_square);
+    board_set_castling_rights(&game->board, game->board.castling_rights & castling_rights_mask[src_square] & castling_rights_mask[dst_square]);
+    game->status_valid = false;
+}
+
+bool8 make_chess_move(chess_game* game, chess_move move) {
+    if (game->board.mailbox[chess_move_from(move)] == MAILBOX_EMPTY) return false;
+    if (game->history.count == MAX_GAME_PLY) return false;
+    board_make_move(&game->board, move, &game->history.moves[game->history.count++]);
+    game->status_valid = false;
+    return true;
+}
+
+bool8 unmake_chess_move(chess_game* game) {
+    if (game->history.count == 0) return false;
+    board_unmake_move(&game->board, &game->history.moves[--game->history.count]);
+    game->status_valid = false;
+    return true;
+}
+
+chess_piece get_chess_piece_by_board_pos(const chess_game* game, vec2 board_pos) {
+    if (!is_board_pos_on_board(board_pos)) {
+        chess_piece ret = {
+            .board_pos = (vec2){-1.0f, -1.0f},
+            .is_white = false,
+            .type = chess_piece_type_none};
+        return ret;
+    }
+    return board_get_piece(&game->board, board_pos_to_square(board_pos));
+}
+
+u32 get_chess_piece_count(const chess_game* game) {
+    return game->board.piece_count;
+}
+
+chess_piece get_chess_piece_by_index(const chess_game* game, u32 index) {
+    return board_get_piece(&game->board, game->board.piece_squares[index]);
+}
+typedef struct {
+    u32 king_square;
+    bitboard checkers;
+    bitboard pinned;
+    bitboard check_mask;
+} legal_move_state;
+
+static bitboard get_move_targets(const chess_board* board, u32 square, chess_piece_type type, bool8 is_white) {
+    bitboard own = board->occupancy[is_white];
+    switch (type) {
+        case chess_piece_type_pawn: {
+            bitboard bit = 1ULL << square;
+            bitboard single_push = (is_white ? bit << 8 : bit >> 8) & ~board->occupied;
+            bitboard double_push = 0;
+            if (bit & (is_white ? BITBOARD_RANK_2 : BITBOARD_RANK_7)) {
+                double_push = (is_white ? single_push << 8 : single_push >> 8) & ~board->occupied;
+            }
+            return single_push | double_push | (pawn_attack_table[is_white][square] & board->occupancy[!is_white]);
+        }
+        case chess_piece_type_knight:
+            return knight_attack_table[square] & ~own;
+        case chess_piece_type_bishop:
+            return bishop_attacks(square, board->occupied) & ~own;
+        case chess_piece_type_rook:
+            return rook_attacks(square, board->occupied) & ~own;
+        case chess_piece_type_queen:
+            return (rook_attacks(square, board->occupied) | bishop_attacks(square, board->occupied)) & ~own;
+        case chess_piece_type_king:
+            return king_attack_table[square] & ~own;
+        default:
+            return 0;
+    }
+}
+
+static bitboard attackers_to_square(const chess_board* board, u32 square, bitboard occupied) {
+    bitboard rooks_queens = board->pieces[false][chess_piece_type_rook - 1] | board->pieces[true][chess_piece_type_rook - 1] |
+                            board->pieces[false][chess_piece_type_queen - 1] | board->pieces[true][chess_piece_type_queen - 1];
+    bitboard bishops_queens = board->pieces[false][chess_piece_type_bishop - 1] | board->pieces[true][chess_piece_type_bishop - 1] |
+                              board->pieces[false][chess_piece_type_queen - 1] | board->pieces[true][chess_piece_type_queen - 1];
+    return (pawn_attack_table[false][square] & board->pieces[true][chess_piece_type_pawn - 1]) |
+           (pawn_attack_table[true][square] & board->pieces[false][chess_piece_type_pawn - 1]) |
+           (knight_attack_table[square] & (board->pieces[false][chess_piece_type_knight - 1] | board->pieces[true][chess_piece_type_knight - 1])) |
+           (king_attack_table[square] & (board->pieces[false][chess_piece_type_king - 1] | board->pieces[true][chess_piece_type_king - 1])) |
+           (rook_attacks(square, occupied) & rooks_queens) |
+           (bishop_attacks(square, occupied) & bishops_queens);
+}
+
+static legal_move_state compute_legal_move_state(const chess_board* board, bool8 is_white) {
+    legal_move_state state = {
+        .king_square = BOARD_SQUARE_COUNT,
+        .checkers = 0,
+        .pinned = 0,
+        .check_mask = ~0ULL};
+    bitboard king = board->pieces[is_white][chess_piece_type_king - 1];
+    if (!king) return state;
+    state.king_square = __builtin_ctzll(king);
+
+    bitboard enemy = board->occupancy[!is_white];
+    state.checkers = attackers_to_square(board, state.king_square, board->occupied) & enemy;
+    if (state.checkers) {
+        state.check_mask = 0;
+        if (!(state.checkers & (state.checkers - 1))) {
+            state.check_mask = state.checkers | between_table[state.king_square][__builtin_ctzll(state.checkers)];
+        }
+    }
+
+    bitboard enemy_rooks_queens = board->pieces[!is_white][chess_piece_type_rook - 1] | board->pieces[!is_white][chess_piece_type_queen - 1];
+    bitboard enemy_bishops_queens = board->pieces[!is_white][chess_piece_type_bishop - 1] | board->pieces[!is_white][chess_piece_type_queen - 1];
+    bitboard snipers = (rook_attacks(state.king_square, enemy) & enemy_rooks_queens) |
+                       (bishop_attacks(state.king_square, enemy) & enemy_bishops_queens);
+    while (snipers) {
+        bitboard blockers = between_table[state.king_square][bitboard_pop_lsb(&snipers)] & board->occupied;
+        if (blockers && !(blockers & (blockers - 1))) {
+            state.pinned |= blockers & board->occupancy[is_white];
+        }
+    }
+    return state;
+}
+
+static bool8 is_square_attacked(const chess_board* board, u32 square, bool8 by_white) {
+    return (attackers_to_square(board, square, board->occupied) & board->occupancy[by_white]) != 0;
+}
+
+static void push_chess_move(chess_move_list* list, u32 from, u32 to, u32 flags) {
+    if (list->count == MAX_CHESS_MOVES) {
+        list->overflow = true;
+        return;
+    }
+    list->moves[list->count++] = chess_move_create(from, to, flags);
+}
+
+static void push_target_moves(chess_move_list* list, u32 from, bitboard targets, bitboard occupied) {
+    while (targets) {
+        u32 to = bitboard_pop_lsb(&targets);
+        push_chess_move(list, from, to, (occupied & (1ULL << to)) ? chess_move_flag_capture : chess_move_flag_quiet);
+    }
+}
+
+static void push_pawn_target_moves(chess_move_list* list, u32 from, bitboard targets, bitboard occupied) {
+    while (targets) {
+        u32 to = bitboard_pop_lsb(&targets);
+        u32 flags = (occupied & (1ULL << to)) ? chess_move_flag_capture : chess_move_flag_quiet;
+        if ((1ULL << to) & (BITBOARD_RANK_1 | BITBOARD_RANK_8)) {
+            for (i32 promotion = 3; promotion >= 0; promotion--) {
+                push_chess_move(list, from, to, flags | chess_move_flag_promotion | promotion);
+            }
+        } else if (to == from + 2 * BOARD_X_SIZE || from == to + 2 * BOARD_X_SIZE) {
+            push_chess_move(list, from, to, chess_move_flag_double_push);
+        } else {
+            push_chess_move(list, from, to, flags);
+        }
+    }
+}
+
+static bool8 is_en_passant_legal(const chess_board* board, const legal_move_state* state, u32 from, bool8 is_white) {
+    if (state->king_square == BOARD_SQUARE_COUNT) return true;
+    u32 to = board->en_passant_square;
+    bitboard captured = 1ULL << en_passant_captured_square(to, is_white);
+    bitboard occupied = (board->occupied ^ (1ULL << from) ^ captured) | (1ULL << to);
+    return !(attackers_to_square(board, state->king_square, occupied) & board->occupancy[!is_white] & ~captured);
+}
+
+static void generate_castling_moves(const chess_board* board, const legal_move_state* state, u32 king_square, bool8 is_white, chess_move_list* list) {
+    u32 home = is_white ? 4 : 60;
+    u8 king_side = is_white ? CASTLE_WHITE_KING_SIDE : CASTLE_BLACK_KING_SIDE;
+    u8 queen_side = is_white ? CASTLE_WHITE_QUEEN_SIDE : CASTLE_BLACK_QUEEN_SIDE;
+    bitboard rooks = board->pieces[is_white][chess_piece_type_rook - 1];
+    if (king_square != home || !(board->castling_rights & (king_side | queen_side))) return;
+    if (state && state->checkers) return;
+
+    if ((board->castling_rights & king_side) && (rooks & (1ULL << (home + 3))) &&
+        !(board->occupied & ((1ULL << (home + 1)) | (1ULL << (home + 2))))) {
+        if (!state || (!is_square_attacked(board, home + 1, !is_white) && !is_square_attacked(board, home + 2, !is_white))) {
+            push_chess_move(list, home, home + 2, chess_move_flag_king_castle);
+        }
+    }
+    if ((board->castling_rights & queen_side) && (rooks & (1ULL << (home - 4))) &&
+        !(board->occupied & ((1ULL << (home - 1)) | (1ULL << (home - 2)) | (1ULL << (home - 3))))) {
+        if (!state || (!is_square_attacked(board, home - 1, !is_white) && !is_square_attacked(board, home - 2, !is_white))) {
+            push_chess_move(list, home, home - 2, chess_move_flag_queen_castle);
+        }
+    }
+}
+
+/* state == NULL generates pseudo-legal moves */
+static void generate_square_moves(const chess_board* board, const legal_move_state* state, u32 square, chess_move_list* list) {
+    u8 code = board->mailbox[square];
+    chess_piece_type type = code & MAILBOX_TYPE_MASK;
+    bool8 is_white = (code & MAILBOX_WHITE_BIT) != 0;
+    bitboard targets = get_move_targets(board, square, type, is_white);
+
+    if (type == chess_piece_type_king) {
+        if (state) {
+            bitboard occupied = board->occupied & ~(1ULL << square);
+            bitboard candidates = targets;
+            while (candidates) {
+                u32 target = bitboard_pop_lsb(&candidates);
+                if (attackers_to_square(board, target, occupied) & board->occupancy[!is_white]) {
+                    targets &= ~(1ULL << target);
+                }
+            }
+        }
+        push_target_moves(list, square, targets, board->occupied);
+        generate_castling_moves(board, state, square, is_white, list);
+        return;
+    }
+
+    if (state) {
+        targets &= state->check_mask;
+        if (state->pinned & (1ULL << square)) {
+            targets &= line_table[state->king_square][square];
+        }
+    }
+    if (type == chess_piece_type_pawn) {
+        push_pawn_target_moves(list, square, targets, board->occupied);
+        if (board->en_passant_square != NO_SQUARE && (pawn_attack_table[is_white][square] & (1ULL << board->en_passant_square)) &&
+            (!state || is_en_passant_legal(board, state, square, is_white))) {
+            push_chess_move(list, square, board->en_passant_square, chess_move_flag_en_passant);
+        }
+    } else {
+        push_target_moves(list, square, targets, board->occupied);
+    }
+}
+
+static void generate_legal_moves(const chess_board* board, chess_move_list* list) {
+    legal_move_state state = compute_legal_move_state(board, board->white_turn);
+    bitboard pieces = board->occupancy[board->white_turn];
+    if (state.checkers & (state.checkers - 1)) {
+        pieces = board->pieces[board->white_turn][chess_piece_type_king - 1];
+    }
+    list->count = 0;
+    list->overflow = false;
+    while (pieces) {
+        generate_square_moves(board, &state, bitboard_pop_lsb(&pieces), list);
+    }
+}
+
+vec2 get_king_position(const chess_game* game, bool8 is_white) {
+    bitboard king = game->board.pieces[is_white][chess_piece_type_king - 1];
+    if (!king) return (vec2){-1.0f, -1.0f};
+    return square_to_board_pos(__builtin_ctzll(king));
+}
+
+static void board_compute_status(const chess_board* board, chess_game_status* status) {
+    legal_move_state state = compute_legal_move_state(board, board->white_turn);
+    bitboard pieces = board->occupancy[board->white_turn];
+    if (state.checkers & (state.checkers - 1)) {
+        pieces = board->pieces[board->white_turn][chess_piece_type_king - 1];
+    }
+    memset(status->square_move_count, 0, sizeof(status->square_move_count));
+    status->legal_moves.count = 0;
+    status->legal_moves.overflow = false;
+    while (pieces) {
+        u32 square = bitboard_pop_lsb(&pieces);
+        u32 start = status->legal_moves.count;
+        generate_square_moves(board, &state, square, &status->legal_moves);
+        status->square_move_start[square] = (u8)start;
+        status->square_move_count[square] = (u8)(status->legal_moves.count - start);
+    }
+    status->checkers = state.checkers;
+    status->in_check = state.checkers != 0;
+    status->is_checkmate = status->in_check && status->legal_moves.count == 0;
+    status->is_stalemate = !status->in_check && status->legal_moves.count == 0;
+}
+
+static bool8 board_has_legal_move(const chess_board* board) {
+    bool8 is_white = board->white_turn;
+    legal_move_state state = compute_legal_move_state(board, is_white);
+    bitboard king = board->pieces[is_white][chess_piece_type_king - 1];
+    if (king) {
+        bitboard targets = king_attack_table[state.king_square] & ~board->occupancy[is_white];
+        bitboard occupied = board->occupied & ~king;
+        while (targets) {
+            if (!(attackers_to_square(board, bitboard_pop_lsb(&targets), occupied) & board->occupancy[!is_white])) return true;
+        }
+        if (state.checkers & (state.checkers - 1)) return false;
+    }
+
+    bitboard pieces = board->occupancy[is_white] & ~king;
+    while (pieces) {
+        u32 square = bitboard_pop_lsb(&pieces);
+        chess_piece_type type = board->mailbox[square] & MAILBOX_TYPE_MASK;
+        bitboard targets = get_move_targets(board, square, type, is_white) & state.check_mask;
+        if (state.pinned & (1ULL << square)) {
+            targets &= line_table[state.king_square][square];
+        }
+        if (targets) return true;
+        if (type == chess_piece_type_pawn && board->en_passant_square != NO_SQUARE &&
+            (pawn_attack_table[is_white][square] & (1ULL << board->en_passant_square)) && is_en_passant_legal(board, &state, square, is_white)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+chess_game_result get_chess_game_result(const chess_game* game) {
+    if (board_has_legal_move(&game->board)) return chess_game_result_ongoing;
+    return is_king_in_check(game, game->board.white_turn) ? chess_game_result_checkmate : chess_game_result_stalemate;
+}
+
+const chess_game_status* get_chess_game_status(chess_game* game) {
+    if (!game->status_valid) {
+        board_compute_status(&game->board, &game->status);
+        game->status_valid = true;
+    }
+    return &game->status;
+}
+
+bool8 is_king_in_check(const chess_game* game, bool8 white) {
+    bitboard king = game->board.pieces[white][chess_piece_type_king - 1];
+    if (!king) return false;
+    return is_square_attacked(&game->board, __builtin_ctzll(king), !white);
+}
+
+bool8 is_king_in_check_after_move(chess_game* game, chess_move move, bool8 white) {
+    if (game->board.mailbox[chess_move_from(move)] == MAILBOX_EMPTY) return false;
+    chess_undo undo;
+    board_make_move(&game->board, move, &undo);
+    bool8 ret = is_king_in_check(game, !white);
+    board_unmake_move(&game->board, &undo);
+    return ret;
+}
+
+u32 get_available_moves_from_chess_piece(const chess_game* game, chess_piece piece, chess_move_list* available_moves) {
+    available_moves->count = 0;
+    available_moves->overflow = false;
+    if (!is_board_pos_on_board(piece.board_pos)) return 0;
+    u32 square = board_pos_to_square(piece.board_pos);
+    if (game->board.mailbox[square] == MAILBOX_EMPTY) return 0;
+    generate_square_moves(&game->board, NULL, square, available_moves);
+    return available_moves->count;
+}
+
+u32 get_legal_moves_from_chess_piece(const chess_game* game, chess_piece piece, chess_move_list* legal_moves) {
+    legal_moves->count = 0;
+    legal_moves->overflow = false;
+    if (!is_board_pos_on_board(piece.board_pos)) return 0;
+    u32 square = board_pos_to_square(piece.board_pos);
+    if (game->board.mailbox[square] == MAILBOX_EMPTY) return 0;
+    legal_move_state state = compute_legal_move_state(&game->board, (game->board.mailbox[square] & MAILBOX_WHITE_BIT) != 0);
+    generate_square_moves(&game->board, &state, square, legal_moves);
+    return legal_moves->count;
+}
+
+u32 get_all_legal_moves(const chess_game* game, chess_move_list* legal_moves) {
+    generate_legal_moves(&game->board, legal_moves);
+    return legal_moves->count;
+}
+
+void remove_chess_piece_from_board(chess_game* game, vec2 board_pos) {
+    if (!is_board_pos_on_board(board_pos)) return;
+    u32 square = board_pos_to_square(board_pos);
+    board_clear_square(&game->board, square);
+    board_set_castling_rights(&game->board, game->board.castling_rights & castling_rights_mask[square]);
+    game->status_valid = false;
+}
+
+bool8 chess_move_from_string(const chess_game* game, const char* text, chess_move* move) {
+    static const char piece_letters[] = " PBNRQK";
+    chess_move_list moves;
+    generate_legal_moves(&game->board, &moves);
+
+    char san[16];
+    u32 length = 0;
+    for (; text[length] && length < sizeof(san) - 1; length++) san[length] = text[length];
+    while (length && strchr("+#!?", san[length - 1])) length--;
+    san[length] = '\0';
+    if (!length) return false;
+
+    for (u32 i = 0; i < moves.count; i++) {
+        char coordinates[6];
+        chess_move_to_string(moves.moves[i], coordinates);
+        if (strcmp(coordinates, san) == 0) {
+            *move = moves.moves[i];
+            return true;
+        }
+    }
+
+    u32 castle_flags = chess_move_flag_quiet;
+    if (strcmp(san, "O-O") == 0 || strcmp(san, "0-0") == 0) castle_flags = chess_move_flag_king_castle;
+    if (strcmp(san, "O-O-O") == 0 || strcmp(san, "0-0-0") == 0) castle_flags = chess_move_flag_queen_castle;
+    if (castle_flags != chess_move_flag_quiet) {
+        for (u32 i = 0; i < moves.count; i++) {
+            if (chess_move_flags(moves.moves[i]) == castle_flags) {
+                *move = moves.moves[i];
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const char* p = san;
+    chess_piece_type type = chess_piece_type_pawn;
+    const char* letter = strchr(piece_letters + 2, *p);
+    if (*p && letter) {
+        type = letter - piece_letters;
+        p++;
+    }
+    chess_piece_type promotion = chess_piece_type_none;
+    const char* body_end = san + length;
+    letter = type == chess_piece_type_pawn && length > 2 ? strchr(piece_letters + 2, body_end[-1]) : NULL;
+    if (letter && body_end[-1] != 'K') {
+        promotion = letter - piece_letters;
+        body_end -= body_end[-2] == '=' ? 2 : 1;
+    }
+
+    i32 from_file = -1, from_rank = -1, to_file = -1, to_rank = -1;
+    for (; p < body_end; p++) {
+        if (*p >= 'a' && *p <= 'h') {
+            if (to_file >= 0) from_file = to_file;
+            to_file = *p - 'a';
+        } else if (*p >= '1' && *p <= '8') {
+            if (to_rank >= 0) from_rank = to_rank;
+            to_rank = *p - '1';
+        } else if (*p != 'x' && *p != '-' && *p != ':') {
+            return false;
+        }
+    }
+    if (to_file < 0 || to_rank < 0) return false;
+    u32 to = to_rank * BOARD_X_SIZE + to_file;
+
+    u32 match_count = 0;
+    for (u32 i = 0; i < moves.count; i++) {
+        chess_move candidate = moves.moves[i];
+        u32 from = chess_move_from(candidate);
+        if (chess_move_to(candidate) != to || (game->board.mailbox[from] & MAILBOX_TYPE_MASK) != type) continue;
+        if ((from_file >= 0 && (i32)(from % BOARD_X_SIZE) != from_file) || (from_rank >= 0 && (i32)(from / BOARD_X_SIZE) != from_rank)) continue;
+        if (chess_move_promotion_type(candidate) != promotion) continue;
+        *move = candidate;
+        match_count++;
+    }
+    return match_count == 1;
+}
+
+/* ============================ */
+/*   FEN AND POSITION RECORDS   */
+/* ============================ */
+
+static const char fen_piece_chars[] = " pbnrqk";
+
+static const u8 fen_piece_codes[128] = {
+    ['p'] = chess_piece_type_pawn, ['b'] = chess_piece_type_bishop, ['n'] = chess_piece_type_knight,
+    ['r'] = chess_piece_type_rook, ['q'] = chess_piece_type_queen, ['k'] = chess_piece_type_king,
+    ['P'] = chess_piece_type_pawn | MAILBOX_WHITE_BIT, ['B'] = chess_piece_type_bishop | MAILBOX_WHITE_BIT,
+    ['N'] = chess_piece_type_knight | MAILBOX_WHITE_BIT, ['R'] = chess_piece_type_rook | MAILBOX_WHITE_BIT,
+    ['Q'] = chess_piece_type_queen | MAILBOX_WHITE_BIT, ['K'] = chess_piece_type_king | MAILBOX_WHITE_BIT};
+
+static const char* skip_fen_spaces(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t')) p++;
+    return p;
+}
+
+static const char* parse_fen_number(const char* p, const char* end, u16* number) {
+    u32 value = 0;
+    const char* start = p;
+    while (p < end && *p >= '0' && *p <= '9') {
+        value = value * 10 + (*p++ - '0');
+        if (value > 0xFFFF) return NULL;
+    }
+    if (p == start) return NULL;
+    *number = (u16)value;
+    return p;
+}
+
+static const char* parse_fen_fields(const char* p, const char* end, chess_position_record* record) {
+    memset(record, 0, sizeof(*record));
+    record->en_passant_square = NO_SQUARE;
+    record->fullmove_number = 1;
+
+    /* squares are visited a8..h8, a7..h7, ..., so pieces are collected top rank first and reordered below */
+    u8 codes[BOARD_SQUARE_COUNT];
+    bitboard occupied = 0;
+    u32 x = 0, y = 0, piece_count = 0;
+    for (; p < end && *p != ' '; p++) {
+        u8 c = (u8)*p;
+        if (c == '/') {
+            if (x != BOARD_X_SIZE || ++y == BOARD_Y_SIZE) return NULL;
+            x = 0;
+        } else if (c >= '1' && c <= '8') {
+            x += c - '0';
+            if (x > BOARD_X_SIZE) return NULL;
+        } else {
+            u8 code = c < 128 ? fen_piece_codes[c] : MAILBOX_EMPTY;
+            if (code == MAILBOX_EMPTY || x >= BOARD_X_SIZE || piece_count == CHESS_RECORD_MAX_PIECES) return NULL;
+            u32 square = (BOARD_Y_SIZE - 1 - y) * BOARD_X_SIZE + x++;
+            occupied |= 1ULL << square;
+            codes[square] = code;
+            piece_count++;
+        }
+    }
+    if (x != BOARD_X_SIZE || y != BOARD_Y_SIZE - 1) return NULL;
+
+    record->occupied = occupied;
+    for (u32 i = 0; occupied; i++) {
+        record->pieces[i / 2] |= codes[bitboard_pop_lsb(&occupied)] << (4 * (i % 2));
+    }
+
+    p = skip_fen_spaces(p, end);
+    if (p == end || (*p != 'w' && *p != 'b')) return NULL;
+    record->white_turn = *p++ == 'w';
+
+    p = skip_fen_spaces(p, end);
+    if (p == end) return NULL;
+    if (*p == '-') {
+        p++;
+    } else {
+        for (; p < end && *p != ' '; p++) {
+            switch (*p) {
+                case 'K': record->castling_rights |= CASTLE_WHITE_KING_SIDE; break;
+                case 'Q': record->castling_rights |= CASTLE_WHITE_QUEEN_SIDE; break;
+                case 'k': record->castling_rights |= CASTLE_BLACK_KING_SIDE; break;
+                case 'q': record->castling_rights |= CASTLE_BLACK_QUEEN_SIDE; break;
+                default: return NULL;
+            }
+        }
+    }
+
+    p = skip_fen_spaces(p, end);
+    if (p == end) return NULL;
+    if (*p == '-') {
+        p++;
+    } else {
+        if (end - p < 2 || p[0] < 'a' || p[0] > 'h' || (p[1] != '3' && p[1] != '6')) return NULL;
+        record->en_passant_square = (p[1] - '1') * BOARD_X_SIZE + (p[0] - 'a');
+        p += 2;
+    }
+
+    /* the move counters are optional, EPD lines continue with operations instead */
+    const char* counters = skip_fen_spaces(p, end);
+    const char* next = counters < end ? parse_fen_number(counters, end, &record->halfmove_clock) : NULL;
+    if (next) {
+        p = next;
+        counters = skip_fen_spaces(p, end);
+        next = counters < end ? parse_fen_number(counters, end, &record->fullmove_number) : NULL;
+        if (next) p = next;
+    }
+    return p;
+}
+
+const char* chess_parse_fen(const char* fen, chess_position_record* record) {
+    return parse_fen_fields(fen, fen + strlen(fen), record);
+}
+
+static bool8 is_board_position_valid(const chess_board* board) {
+    for (u32 is_white = 0; is_white < 2; is_white++) {
+        bitboard pawns = board->pieces[is_white][chess_piece_type_pawn - 1];
+        if (__builtin_popcountll(board->pieces[is_white][chess_piece_type_king - 1]) != 1) return false;
+        if (__builtin_popcountll(board->occupancy[is_white]) > 16 || __builtin_popcountll(pawns) > 8) return false;
+        if (pawns & (BITBOARD_RANK_1 | BITBOARD_RANK_8)) return false;
+    }
+
+    bool8 white = board->white_turn;
+    if (board->en_passant_square != NO_SQUARE) {
+        u32 square = board->en_passant_square;
+        u32 pushed_pawn = white ? square - 8 : square + 8;
+        if (square / BOARD_X_SIZE != (white ? 5u : 2u)) return false;
+        if (!(board->pieces[!white][chess_piece_type_pawn - 1] & (1ULL << pushed_pawn))) return false;
+    }
+
+    /* the side that just moved can not be left in check */
+    bitboard king = board->pieces[!white][chess_piece_type_king - 1];
+    return !is_square_attacked(board, __builtin_ctzll(king), white);
+}
+
+bool8 chess_board_load_record(chess_game* game, const chess_position_record* record) {
+    if (record->castling_rights > CASTLE_ALL || (record->en_passant_square != NO_SQUARE && record->en_passant_square >= BOARD_SQUARE_COUNT)) return false;
+    init_attack_tables();
+    chess_board board;
+    memset(&board, 0, sizeof(board));
+    board.en_passant_square = NO_SQUARE;
+
+    bitboard occupied = record->occupied;
+    for (u32 i = 0; occupied; i++) {
+        if (i == CHESS_RECORD_MAX_PIECES) return false;
+        u8 code = (record->pieces[i / 2] >> (4 * (i % 2))) & 0xF;
+        chess_piece_type type = code & MAILBOX_TYPE_MASK;
+        if (type == chess_piece_type_none || type > chess_piece_type_king) return false;
+        board_put_piece(&board, bitboard_pop_lsb(&occupied), type, (code & MAILBOX_WHITE_BIT) != 0);
+    }
+    board_set_castling_rights(&board, record->castling_rights);
+    board_set_en_passant_square(&board, record->en_passant_square);
+    if (record->white_turn) board_toggle_turn(&board);
+    board.halfmove_clock = record->halfmove_clock;
+    board.fullmove_number = record->fullmove_number;
+    if (!is_board_position_valid(&board)) return false;
+
+    game->board = board;
+    game->history.count = 0;
+    game->status_valid = false;
+    return true;
+}
+
+bool8 chess_board_save_record(const chess_game* game, chess_position_record* record) {
+    const chess_board* board = &game->board;
+    if (board->piece_count > CHESS_RECORD_MAX_PIECES) return false;
+    memset(record, 0, sizeof(*record));
+    record->occupied = board->occupied;
+    bitboard occupied = board->occupied;
+    for (u32 i = 0; occupied; i++) {
+        record->pieces[i / 2] |= board->mailbox[bitboard_pop_lsb(&occupied)] << (4 * (i % 2));
+    }
+    record->white_turn = board->white_turn;
+    record->castling_rights = board->castling_rights;
+    record->en_passant_square = board->en_passant_square;
+    record->halfmove_clock = board->halfmove_clock;
+    record->fullmove_number = board->fullmove_number;
+    return true;
+}
+
+bool8 chess_board_load_fen(chess_game* game, const char* fen) {
+    chess_position_record record;
+    const char* rest = chess_parse_fen(fen, &record);
+    if (!rest || *skip_fen_spaces(rest, rest + strlen(rest)) != '\0') return false;
+    return chess_board_load_record(game, &record);
+}
+
+u32 chess_board_to_fen(const chess_game* game, char* buffer) {
+    const chess_board* board = &game->board;
+    char* p = buffer;
+    for (i32 y = BOARD_Y_SIZE - 1; y >= 0; y--) {
+        u32 empty = 0;
+        for (u32 x = 0; x < BOARD_X_SIZE; x++) {
+            u8 code = board->mailbox[y * BOARD_X_SIZE + x];
+            if (code == MAILBOX_EMPTY) {
+                empty++;
+                continue;
+            }
+            if (empty) *p++ = '0' + empty;
+            empty = 0;
+            char c = fen_piece_chars[code & MAILBOX_TYPE_MASK];
+            *p++ = (code & MAILBOX_WHITE_BIT) ? c - 0x20 : c;
+        }
+        if (empty) *p++ = '0' + empty;
+        if (y) *p++ = '/';
+    }
+    *p++ = ' ';
+    *p++ = board->white_turn ? 'w' : 'b';
+    *p++ = ' ';
+    if (!board->castling_rights) *p++ = '-';
+    if (board->castling_rights & CASTLE_WHITE_KING_SIDE) *p++ = 'K';
+    if (board->castling_rights & CASTLE_WHITE_QUEEN_SIDE) *p++ = 'Q';
+    if (board->castling_rights & CASTLE_BLACK_KING_SIDE) *p++ = 'k';
+    if (board->castling_rights & CASTLE_BLACK_QUEEN_SIDE) *p++ = 'q';
+    *p++ = ' ';
+    if (board->en_passant_square == NO_SQUARE) {
+        *p++ = '-';
+    } else {
+        *p++ = 'a' + board->en_passant_square % BOARD_X_SIZE;
+        *p++ = '1' + board->en_passant_square / BOARD_X_SIZE;
+    }
+    p += sprintf(p, " %u %u", board->halfmove_clock, board->fullmove_number);
+    return (u32)(p - buffer);
+}
+
+u64 chess_parse_fen_lines(const char* text, u64 length, chess_position_record* records, u64 capacity, u64* invalid_lines) {
+    const char* p = text;
+    const char* end = text + length;
+    u64 count = 0;
+    while (p < end && count < capacity) {
+        const char* line_end = memchr(p, '\n', end - p);
+        if (!line_end) line_end = end;
+        const char* content_end = line_end;
+        while (content_end > p && (content_end[-1] == '\r' || content_end[-1] == ' ' || content_end[-1] == '\t')) content_end--;
+        p = skip_fen_spaces(p, content_end);
+        if (p < content_end) {
+            if (parse_fen_fields(p, content_end, &records[count])) {
+                count++;
+            } else if (invalid_lines) {
+                (*invalid_lines)++;
+            }
+        }
+        p = line_end + 1;
+    }
+    return count;
+}
+
+chess_position_record* chess_load_fen_file(const char* path, u64* record_count, u64* invalid_lines) {
+    *record_count = 0;
+    if (invalid_lines) *invalid_lines = 0;
+    FILE* file = fopen(path, "rb");
+    if (!file) return NULL;
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char* text = length >= 0 ? malloc(length + 1) : NULL;
+    if (!text || fread(text, 1, length, file) != (size_t)length) {
+        free(text);
+        fclose(file);
+        return NULL;
+    }
+    fclose(file);
+
+    u64 line_count = 1;
+    for (const char* p = text; (p = memchr(p, '\n', text + length - p)); p++) line_count++;
+    chess_position_record* records = malloc(line_count * sizeof(chess_position_record));
+    if (records) {
+        *record_count = chess_parse_fen_lines(text, length, records, line_count, invalid_lines);
+    }
+    free(text);
+    return records;
+}
+
+/* ============================ */
+/*            PERFT             */
+/* ============================ */
+
+#define MAX_PERFT_THREADS 64
+
+/* lockless entry: check holds key ^ data, so a torn write from another thread fails the key test */
+typedef struct {
+    u64 check;
+    u64 data;
+} perft_hash_entry;
+
+typedef struct {
+    perft_hash_entry* entries;
+    u64 mask;
+} perft_hash_table;
+
+typedef struct {
+    chess_board board;
+    const chess_move_list* root_moves;
+    u64* move_nodes;
+    u32* next_move;
+    u32 depth;
+    perft_hash_table* table;
+} perft_worker;
+
+static u64 board_perft(chess_board* board, u32 depth, perft_hash_table* table) {
+    if (depth == 0) return 1;
+
+    perft_hash_entry* entry = NULL;
+    u64 key = 0;
+    if (table && depth > 1) {
+        key = board->key;
+        entry = &table->entries[key & table->mask];
+        u64 data = __atomic_load_n(&entry->data, __ATOMIC_RELAXED);
+        u64 check = __atomic_load_n(&entry->check, __ATOMIC_RELAXED);
+        if ((check ^ data) == key && (data & 0xFF) == depth) return data >> 8;
+    }
+
+    chess_move_list moves;
+    generate_legal_moves(board, &moves);
+    if (depth == 1) return moves.count;
+
+    u64 nodes = 0;
+    for (u32 i = 0; i < moves.count; i++) {
+        chess_undo undo;
+        board_make_move(board, moves.moves[i], &undo);
+        nodes += board_perft(board, depth - 1, table);
+        board_unmake_move(board, &undo);
+    }
+
+    if (entry) {
+        u64 data = (nodes << 8) | depth;
+        __atomic_store_n(&entry->check, key ^ data, __ATOMIC_RELAXED);
+        __atomic_store_n(&entry->data, data, __ATOMIC_RELAXED);
+    }
+    return nodes;
+}
+
+static void* perft_worker_run(void* arg) {
+    perft_worker* worker = arg;
+    for (;;) {
+        u32 index = __atomic_fetch_add(worker->next_move, 1, __ATOMIC_RELAXED);
+        if (index >= worker->root_moves->count) break;
+        chess_undo undo;
+        board_make_move(&worker->board, worker->root_moves->moves[index], &undo);
+        worker->move_nodes[index] = board_perft(&worker->board, worker->depth - 1, worker->table);
+        board_unmake_move(&worker->board, &undo);
+    }
+    return NULL;
+}
+
+u64 chess_perft(chess_game* game, u32 depth) {
+    return board_perft(&game->board, depth, NULL);
+}
+
+u64 chess_perft_parallel(const chess_game* game, u32 depth, u32 thread_count, u32 hash_megabytes, u64* move_nodes) {
+    if (depth == 0) return 1;
+
+    chess_move_list root_moves;
+    u64 root_nodes[MAX_CHESS_MOVES];
+    generate_legal_moves(&game->board, &root_moves);
+    if (!move_nodes) move_nodes = root_nodes;
+
+    perft_hash_table table = {0};
+    if (hash_megabytes) {
+        u64 entry_count = 1;
+        while (entry_count * 2 * sizeof(perft_hash_entry) <= ((u64)hash_megabytes << 20)) entry_count *= 2;
+        table.entries = calloc(entry_count, sizeof(perft_hash_entry));
+        table.mask = entry_count - 1;
+    }
+
+    if (thread_count > MAX_PERFT_THREADS) thread_count = MAX_PERFT_THREADS;
+    if (thread_count > root_moves.count) thread_count = root_moves.count;
+    if (thread_count == 0) thread_count = 1;
+
+    perft_worker workers[MAX_PERFT_THREADS];
+    pthread_t threads[MAX_PERFT_THREADS];
+    bool8 thread_started[MAX_PERFT_THREADS] = {0};
+    u32 next_move = 0;
+    for (u32 i = 0; i < thread_count; i++) {
+        workers[i] = (perft_worker){
+            .board = game->board,
+            .root_moves = &root_moves,
+            .move_nodes = move_nodes,
+            .next_move = &next_move,
+            .depth = depth,
+            .table = table.entries ? &table : NULL};
+    }
+    for (u32 i = 1; i < thread_count; i++) {
+        thread_started[i] = pthread_create(&threads[i], NULL, perft_worker_run, &workers[i]) == 0;
+    }
+    perft_worker_run(&workers[0]);
+    for (u32 i = 1; i < thread_count; i++) {
+        if (thread_started[i]) pthread_join(threads[i], NULL);
+    }
+    free(table.entries);
+
+    u64 nodes = 0;
+    for (u32 i = 0; i < root_moves.count; i++) {
+        nodes += move_nodes[i];
+    }
+    return nodes;
+}
@@ -0,0 +1,221 @@
+#pragma once
+
+#include "types.h"
+
+/* ============================ */
+/*        CHESS RULES API       */
+/* ============================ */
+
+#define BOARD_X_SIZE 8
+#define BOARD_Y_SIZE 8
+#define BOARD_SQUARE_COUNT (BOARD_X_SIZE * BOARD_Y_SIZE)
+
+typedef enum {
+    chess_piece_type_none = 0,
+    chess_piece_type_pawn,
+    chess_piece_type_bishop,
+    chess_piece_type_knight,
+    chess_piece_type_rook,
+    chess_piece_type_queen,
+    chess_piece_type_king
+} chess_piece_type;
+
+typedef struct {
+    chess_piece_type type;
+    vec2 board_pos;
+    bool8 is_white;
+    bool8 pawn_moved;
+} chess_piece;
+
+typedef u16 chess_move;
+
+typedef enum {
+    chess_move_flag_quiet = 0,
+    chess_move_flag_double_push = 1,
+    chess_move_flag_king_castle = 2,
+    chess_move_flag_queen_castle = 3,
+    chess_move_flag_capture = 4,
+    chess_move_flag_en_passant = 5,
+    chess_move_flag_promotion = 8
+} chess_move_flag;
+
+/* more than any legal position has, moves past it are dropped and flag the list as overflowed */
+#define MAX_CHESS_MOVES 256
+
+typedef struct {
+    chess_move moves[MAX_CHESS_MOVES];
+    u32 count;
+    bool8 overflow;
+} chess_move_list;
+
+static inline chess_move chess_move_create(u32 from, u32 to, u32 flags) {
+    return (chess_move)(from | (to << 6) | (flags << 12));
+}
+
+static inline u32 chess_move_from(chess_move move) {
+    return move & 0x3F;
+}
+
+static inline u32 chess_move_to(chess_move move) {
+    return (move >> 6) & 0x3F;
+}
+
+static inline u32 chess_move_flags(chess_move move) {
+    return move >> 12;
+}
+
+chess_piece_type chess_move_promotion_type(chess_move move);
+
+/* writes the move in coordinate notation (e.g. "e2e4", "e7e8q"), buffer needs 6 bytes */
+void chess_move_to_string(chess_move move, char* buffer);
+
+static inline bool8 is_board_pos_on_board(vec2 board_pos) {
+    return board_pos.x >= 0 && board_pos.x < BOARD_X_SIZE && board_pos.y >= 0 && board_pos.y < BOARD_Y_SIZE;
+}
+
+static inline u32 board_pos_to_square(vec2 board_pos) {
+    return (BOARD_Y_SIZE - 1 - (u32)board_pos.y) * BOARD_X_SIZE + (u32)board_pos.x;
+}
+
+static inline vec2 square_to_board_pos(u32 square) {
+    return (vec2){square % BOARD_X_SIZE, BOARD_Y_SIZE - 1 - square / BOARD_X_SIZE};
+}
+
+typedef enum {
+    slider_attack_backend_portable = 0,
+    slider_attack_backend_magic,
+    slider_attack_backend_pext,
+    slider_attack_backend_count
+} slider_attack_backend;
+
+/* all tables are built once at startup, so the backend can be switched while other threads play games */
+bool8 set_slider_attack_backend(slider_attack_backend backend);
+
+slider_attack_backend get_slider_attack_backend();
+
+const char* get_slider_attack_backend_name(slider_attack_backend backend);
+
+/* all game state lives in a chess_game, separate games can be used from separate threads */
+typedef struct chess_game chess_game;
+
+#define MAX_GAME_PLY 2048
+
+chess_game* chess_game_create();
+
+void chess_game_destroy(chess_game* game);
+
+void chess_board_default_placement(chess_game* game);
+
+bool8 is_white_turn(const chess_game* game);
+
+/* Zobrist key of the position, kept up to date incrementally by every board update */
+u64 get_chess_position_key(const chess_game* game);
+
+/* recomputes the Zobrist key from scratch, should always equal get_chess_position_key() */
+u64 compute_chess_position_key(const chess_game* game);
+
+void add_chess_piece_to_board(chess_game* game, vec2 pos, chess_piece_type type, bool8 is_white);
+
+void move_chess_piece_on_board(chess_game* game, vec2 src_pos, vec2 dst_pos);
+
+void remove_chess_piece_from_board(chess_game* game, vec2 board_pos);
+
+/* fails when the origin square is empty or the game already holds MAX_GAME_PLY moves */
+bool8 make_chess_move(chess_game* game, chess_move move);
+
+bool8 unmake_chess_move(chess_game* game);
+
+chess_piece get_chess_piece_by_board_pos(const chess_game* game, vec2 board_pos);
+
+u32 get_chess_piece_count(const chess_game* game);
+
+chess_piece get_chess_piece_by_index(const chess_game* game, u32 index);
+
+u32 get_available_moves_from_chess_piece(const chess_game* game, chess_piece piece, chess_move_list* available_moves);
+
+u32 get_legal_moves_from_chess_piece(const chess_game* game, chess_piece piece, chess_move_list* legal_moves);
+
+u32 get_all_legal_moves(const chess_game* game, chess_move_list* legal_moves);
+
+/* resolves a move in SAN ("Nbd7", "exd8=Q+", "O-O") or coordinate notation ("e7e8q") against the legal moves */
+bool8 chess_move_from_string(const chess_game* game, const char* text, chess_move* move);
+
+bool8 is_king_in_check(const chess_game* game, bool8 white);
+
+bool8 is_king_in_check_after_move(chess_game* game, chess_move move, bool8 white);
+
+vec2 get_king_position(const chess_game* game, bool8 white);
+
+/* the side to move's checkers and legal moves (grouped by origin square) with the mate and stalemate flags */
+typedef struct {
+    u64 checkers;
+    bool8 in_check;
+    bool8 is_checkmate;
+    bool8 is_stalemate;
+    chess_move_list legal_moves;
+    u8 square_move_start[BOARD_SQUARE_COUNT];
+    u8 square_move_count[BOARD_SQUARE_COUNT];
+} chess_game_status;
+
+/* computed on first use after the position changes and cached until the next change */
+const chess_game_status* get_chess_game_status(chess_game* game);
+
+typedef enum {
+    chess_game_result_ongoing = 0,
+    chess_game_result_checkmate,
+    chess_game_result_stalemate
+} chess_game_result;
+
+/* mate and stalemate test for the side to move, stops at the first legal move it finds (king moves first) */
+chess_game_result get_chess_game_result(const chess_game* game);
+
+static inline const chess_move* get_chess_game_status_moves(const chess_game_status* status, u32 square, u32* count) {
+    *count = status->square_move_count[square];
+    return &status->legal_moves.moves[status->square_move_start[square]];
+}
+
+u64 chess_perft(chess_game* game, u32 depth);
+
+/* splits the root moves across thread_count threads sharing a hash_megabytes table (0 disables it),
+   move_nodes optionally receives (MAX_CHESS_MOVES entries) the count below each move in get_all_legal_moves order */
+u64 chess_perft_parallel(const chess_game* game, u32 depth, u32 thread_count, u32 hash_megabytes, u64* move_nodes);
+
+/* ============================ */
+/*   FEN AND POSITION RECORDS   */
+/* ============================ */
+
+#define CHESS_FEN_MAX_LENGTH 128
+#define CHESS_RECORD_MAX_PIECES 32
+
+/* 32 byte position: the occupied squares plus one 4-bit piece code per occupied square in ascending order */
+typedef struct {
+    u64 occupied;
+    u8 pieces[CHESS_RECORD_MAX_PIECES / 2];
+    bool8 white_turn;
+    u8 castling_rights;
+    u8 en_passant_square;
+    u16 halfmove_clock;
+    u16 fullmove_number;
+} chess_position_record;
+
+/* parses the FEN fields (move counters optional) and returns a pointer past them, NULL when malformed */
+const char* chess_parse_fen(const char* fen, chess_position_record* record);
+
+/* fails on positions that can not occur in a game: not exactly one king per side, more than 16 pieces
+   or 8 pawns per side, pawns on the first or last rank, an en passant square without the pawn that
+   just double pushed, or the side not to move in check */
+bool8 chess_board_load_record(chess_game* game, const chess_position_record* record);
+
+/* fails when the board holds more pieces than a record can store */
+bool8 chess_board_save_record(const chess_game* game, chess_position_record* record);
+
+bool8 chess_board_load_fen(chess_game* game, const char* fen);
+
+/* buffer needs CHESS_FEN_MAX_LENGTH bytes, returns the length written */
+u32 chess_board_to_fen(const chess_game* game, char* buffer);
+
+/* one FEN per line, blank lines are skipped and anything after the FEN fields (EPD operations) is ignored */
+u64 chess_parse_fen_lines(const char* text, u64 length, chess_position_record* records, u64 capacity, u64* invalid_lines);
+
+/* loads a whole FEN file into a single records array, release it with free() */
+chess_position_record* chess_load_fen_file(const char* path, u64* record_count, u64* invalid_lines);
@@ -0,0 +1,288 @@
+#include "chess_rules.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+/* ============================ */
+/*          EPD RECORDS         */
+/* ============================ */
+
+#define EPD_MAX_DEPTH 8
+#define EPD_MAX_MOVES 8
+#define EPD_DEFAULT_MAX_DEPTH 4
+#define EPD_MAX_THREADS 64
+
+typedef struct {
+    chess_position_record position;
+    u32 line_number;
+    char id[64];
+    u64 expected_nodes[EPD_MAX_DEPTH];
+    char best_moves[EPD_MAX_MOVES][16];
+    u32 best_move_count;
+    char avoid_moves[EPD_MAX_MOVES][16];
+    u32 avoid_move_count;
+
+    bool8 malformed;
+    bool8 passed;
+    u64 nodes;
+    double time;
+    char failure[96];
+} epd_record;
+
+typedef struct {
+    epd_record* records;
+    u32 record_count;
+    u32 next_record;
+    u32 max_depth;
+} epd_queue;
+
+static double get_time_seconds() {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static u32 get_default_thread_count() {
+#ifdef _SC_NPROCESSORS_ONLN
+    long cpu_count = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpu_count > 0) return (u32)cpu_count;
+#endif
+    return 1;
+}
+
+static const char* read_epd_operand(const char* p, char* buffer, u32 size) {
+    while (*p == ' ' || *p == '\t') p++;
+    const char* start = p;
+    const char* end;
+    if (*p == '"') {
+        start = ++p;
+        while (*p && *p != '"') p++;
+        end = p;
+        if (*p) p++;
+    } else {
+        while (*p && *p != ' ' && *p != '\t' && *p != ';') p++;
+        end = p;
+    }
+    u32 length = (u32)(end - start) < size - 1 ? (u32)(end - start) : size - 1;
+    memcpy(buffer, start, length);
+    buffer[length] = '\0';
+    return p;
+}
+
+static bool8 parse_epd_line(const char* line, epd_record* record) {
+    memset(record, 0, sizeof(*record));
+    const char* p = chess_parse_fen(line, &record->position);
+    if (!p) return false;
+
+    for (;;) {
+        while (*p == ' ' || *p == '\t' || *p == ';') p++;
+        if (!*p) break;
+        char opcode[16];
+        p = read_epd_operand(p, opcode, sizeof(opcode));
+        while (*p && *p != ';') {
+            char operand[64];
+            p = read_epd_operand(p, operand, sizeof(operand));
+            if (!operand[0]) continue;
+            if (opcode[0] == 'D' && opcode[1] >= '1' && opcode[1] <= '0' + EPD_MAX_DEPTH && !opcode[2]) {
+                record->expected_nodes[opcode[1] - '1'] = strtoull(operand, NULL, 10);
+            } else if (strcmp(opcode, "bm") == 0 && record->best_move_count < EPD_MAX_MOVES) {
+                if (strlen(operand) >= sizeof(record->best_moves[0])) return false;
+                snprintf(record->best_moves[record->best_move_count++], sizeof(record->best_moves[0]), "%s", operand);
+            } else if (strcmp(opcode, "am") == 0 && record->avoid_move_count < EPD_MAX_MOVES) {
+                if (strlen(operand) >= sizeof(record->avoid_moves[0])) return false;
+                snprintf(record->avoid_moves[record->avoid_move_count++], sizeof(record->avoid_moves[0]), "%s", operand);
+            } else if (strcmp(opcode, "id") == 0) {
+                snprintf(record->id, sizeof(record->id), "%s", operand);
+            }
+        }
+    }
+    return true;
+}
+
+/* ============================ */
+/*          EPD RUNNER          */
+/* ============================ */
+
+static void run_epd_record(chess_game* game, epd_record* record, u32 max_depth) {
+    if (record->malformed) return;
+    record->passed = chess_board_load_record(game, &record->position);
+    if (!record->passed) {
+        snprintf(record->failure, sizeof(record->failure), "invalid position");
+        return;
+    }
+
+    /* the early-exit result query must agree with the full status generation */
+    const chess_game_status* status = get_chess_game_status(game);
+    chess_game_result expected_result = status->is_checkmate ? chess_game_result_checkmate :
+                                        status->is_stalemate ? chess_game_result_stalemate : chess_game_result_ongoing;
+    chess_game_result result = get_chess_game_result(game);
+    if (result != expected_result) {
+        record->passed = false;
+        snprintf(record->failure, sizeof(record->failure), "game result %d does not match status %d", result, expected_result);
+        return;
+    }
+
+    for (u32 i = 0; i < record->best_move_count + record->avoid_move_count && record->passed; i++) {
+        const char* text = i < record->best_move_count ? record->best_moves[i] : record->avoid_moves[i - record->best_move_count];
+        chess_move move;
+        if (!chess_move_from_string(game, text, &move)) {
+            record->passed = false;
+            snprintf(record->failure, sizeof(record->failure), "%s is not a legal move", text);
+        }
+    }
+
+    for (u32 depth = 1; depth <= max_depth && depth <= EPD_MAX_DEPTH && record->passed; depth++) {
+        if (!record->expected_nodes[depth - 1]) continue;
+        u64 nodes = chess_perft(game, depth);
+        record->nodes += nodes;
+        if (nodes != record->expected_nodes[depth - 1]) {
+            record->passed = false;
+            snprintf(record->failure, sizeof(record->failure), "D%u expected %llu got %llu", depth, record->expected_nodes[depth - 1], nodes);
+        }
+    }
+}
+
+static void* epd_worker_run(void* arg) {
+    epd_queue* queue = arg;
+    chess_game* game = chess_game_create();
+    if (!game) return NULL;
+    for (;;) {
+        u32 index = __atomic_fetch_add(&queue->next_record, 1, __ATOMIC_RELAXED);
+        if (index >= queue->record_count) break;
+        epd_record* record = &queue->records[index];
+        double start = get_time_seconds();
+        run_epd_record(game, record, queue->max_depth);
+        record->time = get_time_seconds() - start;
+    }
+    chess_game_destroy(game);
+    return NULL;
+}
+
+static epd_record* load_epd_file(const char* path, u32* record_count) {
+    FILE* file = fopen(path, "rb");
+    if (!file) return NULL;
+
+    u32 capacity = 1024;
+    epd_record* records = malloc(capacity * sizeof(epd_record));
+    char line[1024];
+    u32 line_number = 0;
+    *record_count = 0;
+    while (records && fgets(line, sizeof(line), file)) {
+        line_number++;
+        /* a line that does not fit the buffer is skipped to its end and fails as one record */
+        bool8 too_long = false;
+        if (!strchr(line, '\n')) {
+            int c = fgetc(file);
+            too_long = c != EOF && c != '\n';
+            while (c != EOF && c != '\n') c = fgetc(file);
+        }
+        line[strcspn(line, "\r\n")] = '\0';
+        if (!too_long && (!line[strspn(line, " \t")] || line[0] == '#')) continue;
+        if (*record_count == capacity) {
+            capacity *= 2;
+            epd_record* grown = realloc(records, capacity * sizeof(epd_record));
+            if (!grown) {
+                free(records);
+                records = NULL;
+                break;
+            }
+            records = grown;
+        }
+        epd_record* record = &records[*record_count];
+        /* malformed lines stay in the suite as failed records */
+        if (too_long) {
+            memset(record, 0, sizeof(*record));
+            record->malformed = true;
+            snprintf(record->failure, sizeof(record->failure), "EPD line too long");
+        } else if (!parse_epd_line(line, record)) {
+            record->malformed = true;
+            snprintf(record->failure, sizeof(record->failure), "invalid EPD line");
+        }
+        record->line_number = line_number;
+        (*record_count)++;
+    }
+    fclose(file);
+    return records;
+}
+
+static void print_usage(const char* program) {
+    printf("usage: %s [--threads n] [--depth n] [--quiet] file.epd\n", program);
+    printf("  perft records (D1..D%u operations) are checked up to --depth (default: %u)\n", EPD_MAX_DEPTH, EPD_DEFAULT_MAX_DEPTH);
+    printf("  best-move records (bm/am operations) pass when every listed move is legal in the position\n");
+    printf("  --quiet only prints failing records and the summary\n");
+}
+
+int main(int argc, char** argv) {
+    u32 thread_count = get_default_thread_count();
+    u32 max_depth = EPD_DEFAULT_MAX_DEPTH;
+    bool8 quiet = false;
+    const char* path = NULL;
+
+    for (i32 i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            thread_count = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--depth") == 0 && i + 1 < argc) {
+            max_depth = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--quiet") == 0) {
+            quiet = true;
+        } else if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
+            print_usage(argv[0]);
+            return exit_success;
+        } else {
+            path = argv[i];
+        }
+    }
+    if (!path) {
+        print_usage(argv[0]);
+        return exit_failure;
+    }
+
+    u32 record_count = 0;
+    epd_record* records = load_epd_file(path, &record_count);
+    if (!records) {
+        printf("Failed to read '%s'\n", path);
+        return exit_failure;
+    }
+
+    if (thread_count > EPD_MAX_THREADS) thread_count = EPD_MAX_THREADS;
+    if (thread_count == 0) thread_count = 1;
+    printf("%u records  threads %u  max depth %u\n", record_count, thread_count, max_depth);
+
+    epd_queue queue = {
+        .records = records,
+        .record_count = record_count,
+        .next_record = 0,
+        .max_depth = max_depth};
+    pthread_t threads[EPD_MAX_THREADS];
+    bool8 thread_started[EPD_MAX_THREADS] = {0};
+    double start = get_time_seconds();
+    for (u32 i = 1; i < thread_count; i++) {
+        thread_started[i] = pthread_create(&threads[i], NULL, epd_worker_run, &queue) == 0;
+    }
+    epd_worker_run(&queue);
+    for (u32 i = 1; i < thread_count; i++) {
+        if (thread_started[i]) pthread_join(threads[i], NULL);
+    }
+    double elapsed = get_time_seconds() - start;
+
+    u32 passed_count = 0;
+    u64 total_nodes = 0;
+    for (u32 i = 0; i < record_count; i++) {
+        epd_record* record = &records[i];
+        passed_count += record->passed;
+        total_nodes += record->nodes;
+        if (quiet && record->passed) continue;
+        printf("line %-6u %-4s nodes %12llu  time %8.3fs  %s%s%s\n", record->line_number, record->passed ? "ok" : "FAIL",
+               record->nodes, record->time, record->id, record->id[0] && record->failure[0] ? ": " : "", record->failure);
+    }
+    printf("passed %u/%u  nodes %llu  time %.3fs  nps %.0f\n", passed_count, record_count, total_nodes, elapsed,
+           elapsed > 0.0 ? total_nodes / elapsed : 0.0);
+
+    free(records);
+    return passed_count == record_count ? exit_success : exit_failure;
+}
@@ -3,19 +3,31 @@
 out vec4 o_color;
 
 in vec2 v_texcoord;
+in vec4 v_color;
+flat in uint v_flags;
 
 uniform sampler2D u_texture;
 
-uniform int u_using_textures;
-uniform int u_chess_piece_white;
-uniform vec4 u_color;
+layout (std140, binding = 0) uniform frame_constants {
+    mat4 u_proj;
+    vec4 u_board_light_color;
+    vec4 u_board_dark_color;
+    float u_board_square_size;
+};
+
+#define QUAD_FLAG_TEXTURED 1u
+#define QUAD_FLAG_WHITE_PIECE 2u
+#define QUAD_FLAG_CHECKERBOARD 4u
 
 void main() {
-    if(u_using_textures == 0) {
-        o_color = u_color;
+    if((v_flags & QUAD_FLAG_CHECKERBOARD) != 0u) {
+        ivec2 square = ivec2(gl_FragCoord.xy / u_board_square_size);
+        o_color = (square.x + square.y) % 2 == 0 ? u_board_light_color : u_board_dark_color;
+    } else if((v_flags & QUAD_FLAG_TEXTURED) == 0u) {
+        o_color = v_color;
     } else {
-        o_color = texture(u_texture, v_texcoord) * u_color;
-        if(u_chess_piece_white == 1) {
+        o_color = texture(u_texture, v_texcoord) * v_color;
+        if((v_flags & QUAD_FLAG_WHITE_PIECE) != 0u) {
             if(o_color == vec4(0.0, 0.0, 0.0, 1.0)) {
                 o_color = vec4(1.0, 1.0, 1.0, 1.0);
             }
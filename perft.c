@@ -0,0 +1,149 @@
+#include "chess_rules.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+/* ============================ */
+/*        PERFT POSITIONS       */
+/* ============================ */
+
+#define PERFT_MAX_DEPTH 6
+#define PERFT_DEFAULT_HASH_MEGABYTES 64
+
+typedef struct {
+    const char* name;
+    const char* fen;
+    u32 default_depth;
+    u64 expected_nodes[PERFT_MAX_DEPTH];
+} perft_position;
+
+static const perft_position perft_suite[] = {
+    {"startpos", "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 5,
+     {20ULL, 400ULL, 8902ULL, 197281ULL, 4865609ULL, 119060324ULL}},
+    {"kiwipete", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 4,
+     {48ULL, 2039ULL, 97862ULL, 4085603ULL, 193690690ULL, 8031647685ULL}},
+    {"position3", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 6,
+     {14ULL, 191ULL, 2812ULL, 43238ULL, 674624ULL, 11030083ULL}},
+    {"position4", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 5,
+     {6ULL, 264ULL, 9467ULL, 422333ULL, 15833292ULL, 706045033ULL}},
+    {"position5", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 4,
+     {44ULL, 1486ULL, 62379ULL, 2103487ULL, 89941194ULL, 3048196529ULL}},
+    {"position6", "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", 4,
+     {46ULL, 2079ULL, 89890ULL, 3894594ULL, 164075551ULL, 6923051137ULL}}};
+
+#define PERFT_SUITE_SIZE (sizeof(perft_suite) / sizeof(perft_suite[0]))
+
+/* ============================ */
+/*          PERFT TOOL          */
+/* ============================ */
+
+static double get_time_seconds() {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static u32 get_default_thread_count() {
+#ifdef _SC_NPROCESSORS_ONLN
+    long cpu_count = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpu_count > 0) return (u32)cpu_count;
+#endif
+    return 1;
+}
+
+typedef struct {
+    bool8 divide;
+    u32 thread_count;
+    u32 hash_megabytes;
+} perft_options;
+
+static bool8 run_perft_position(chess_game* game, const char* name, const char* fen, u32 depth, u64 expected_nodes, const perft_options* options, u64* total_nodes, double* total_time) {
+    if (!chess_board_load_fen(game, fen)) {
+        printf("%s: invalid FEN '%s'\n", name, fen);
+        return false;
+    }
+    u64 move_nodes[MAX_CHESS_MOVES];
+    double start = get_time_seconds();
+    u64 nodes = chess_perft_parallel(game, depth, options->thread_count, options->hash_megabytes, move_nodes);
+    double elapsed = get_time_seconds() - start;
+
+    if (options->divide && depth > 0) {
+        chess_move_list moves;
+        get_all_legal_moves(game, &moves);
+        for (u32 i = 0; i < moves.count; i++) {
+            char move_string[6];
+            chess_move_to_string(moves.moves[i], move_string);
+            printf("  %-5s %llu\n", move_string, move_nodes[i]);
+        }
+    }
+    *total_nodes += nodes;
+    *total_time += elapsed;
+
+    printf("%-10s depth %u  nodes %12llu  time %8.3fs  nps %12.0f", name, depth, nodes, elapsed, elapsed > 0.0 ? nodes / elapsed : 0.0);
+    if (expected_nodes) {
+        printf("  %s", nodes == expected_nodes ? "ok" : "FAIL");
+    }
+    printf("\n");
+    return !expected_nodes || nodes == expected_nodes;
+}
+
+static void print_usage(const char* program) {
+    printf("usage: %s [--divide] [--threads n] [--hash mb] [depth] [fen]\n", program);
+    printf("  without a FEN the standard positions are run, at their default depth unless one is given\n");
+    printf("  --divide prints the node count below every root move\n");
+    printf("  --threads splits the root moves across n threads (default: one per cpu)\n");
+    printf("  --hash sizes the shared subtree count table, 0 disables it (default: %u)\n", PERFT_DEFAULT_HASH_MEGABYTES);
+}
+
+int main(int argc, char** argv) {
+    perft_options options = {
+        .divide = false,
+        .thread_count = get_default_thread_count(),
+        .hash_megabytes = PERFT_DEFAULT_HASH_MEGABYTES};
+    u32 depth = 0;
+    char fen[256] = {0};
+
+    for (i32 i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--divide") == 0) {
+            options.divide = true;
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            options.thread_count = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--hash") == 0 && i + 1 < argc) {
+            options.hash_megabytes = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
+            print_usage(argv[0]);
+            return exit_success;
+        } else if (!depth && !fen[0] && argv[i][strspn(argv[i], "0123456789")] == '\0' && atoi(argv[i]) > 0) {
+            depth = atoi(argv[i]);
+        } else {
+            if (fen[0]) strncat(fen, " ", sizeof(fen) - strlen(fen) - 1);
+            strncat(fen, argv[i], sizeof(fen) - strlen(fen) - 1);
+        }
+    }
+
+    chess_game* game = chess_game_create();
+    if (!game) return exit_failure;
+    printf("Slider attack backend: %s\n", get_slider_attack_backend_name(get_slider_attack_backend()));
+    printf("threads %u  hash %u MB\n", options.thread_count, options.hash_megabytes);
+
+    bool8 passed = true;
+    u64 total_nodes = 0;
+    double total_time = 0.0;
+    if (fen[0]) {
+        passed = run_perft_position(game, "fen", fen, depth ? depth : 1, 0, &options, &total_nodes, &total_time);
+    } else {
+        for (u32 i = 0; i < PERFT_SUITE_SIZE; i++) {
+            const perft_position* position = &perft_suite[i];
+            u32 position_depth = depth ? depth : position->default_depth;
+            u64 expected_nodes = position_depth <= PERFT_MAX_DEPTH ? position->expected_nodes[position_depth - 1] : 0;
+            passed &= run_perft_position(game, position->name, position->fen, position_depth, expected_nodes, &options, &total_nodes, &total_time);
+        }
+        printf("total      nodes %llu  time %.3fs  nps %.0f\n", total_nodes, total_time, total_time > 0.0 ? total_nodes / total_time : 0.0);
+    }
+    chess_game_destroy(game);
+    return passed ? exit_success : exit_failure;
+}
@@ -1,15 +1,31 @@
 #version 460 core
 
-layout (location = 0) in vec3 a_position;
+layout (location = 0) in vec2 a_position;
 layout (location = 1) in vec2 a_texcoord;
 
-uniform mat4 u_proj;
-uniform mat4 u_model;
+layout (location = 2) in vec4 i_transform;
+layout (location = 3) in vec4 i_color;
+layout (location = 4) in uvec2 i_flags_sprite;
 
+layout (std140, binding = 0) uniform frame_constants {
+    mat4 u_proj;
+    vec4 u_board_light_color;
+    vec4 u_board_dark_color;
+    float u_board_square_size;
+};
+
+layout (std140, binding = 1) uniform sprite_table {
+    vec4 u_sprite_uvs[8];
+};
 
 out vec2 v_texcoord;
+out vec4 v_color;
+flat out uint v_flags;
 
 void main() {
-    v_texcoord = a_texcoord;
-    gl_Position = u_proj * u_model * vec4(a_position, 1.0);
+    vec4 sprite_uv = u_sprite_uvs[i_flags_sprite.y];
+    v_texcoord = mix(sprite_uv.xy, sprite_uv.zw, a_texcoord);
+    v_color = i_color;
+    v_flags = i_flags_sprite.x;
+    gl_Position = u_proj * vec4(a_position * i_transform.zw + i_transform.xy, 0.0, 1.0);
 }